@@ -0,0 +1,176 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+// Measures protocol_detector_match_accounts on synthetic transactions of
+// 10-64 account keys while the registry grows from 2 to 64 programs, next
+// to the per-program memcmp loop the detector used to run and, on AVX2
+// builds, a loop comparing each key against every program id with one
+// 256-bit compare per program.
+//
+// usage: bench_protocol_detector [transactions] [iterations]
+//
+// Nine in ten transactions reference one watched program at a random
+// position, the way server-filtered traffic does; the rest match nothing.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <immintrin.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "protocol_detector.h"
+
+#define MIN_KEYS 10
+#define MAX_KEYS 64
+
+typedef struct {
+    const uint8_t *keys[MAX_KEYS];
+    size_t lens[MAX_KEYS];
+    size_t n_keys;
+} tx_t;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static void random_key(uint8_t key[32]) {
+    for (size_t i = 0; i < 32; i += 8) {
+        uint64_t r = next_random();
+        memcpy(key + i, &r, 8);
+    }
+}
+
+// The detector before the registry: every key against every program.
+static yurei_protocol_t match_linear(const yurei_protocol_detector_t *detector, const tx_t *tx) {
+    for (size_t i = 0; i < tx->n_keys; ++i) {
+        for (size_t p = 0; p < detector->n_programs; ++p) {
+            if (memcmp(tx->keys[i], detector->programs[p].program_id, 32) == 0)
+                return detector->programs[p].protocol;
+        }
+    }
+    return YUREI_PROTOCOL_NONE;
+}
+
+#if defined(__AVX2__)
+static yurei_protocol_t match_vector(const yurei_protocol_detector_t *detector, const tx_t *tx) {
+    for (size_t i = 0; i < tx->n_keys; ++i) {
+        __m256i key = _mm256_loadu_si256((const __m256i *)tx->keys[i]);
+        for (size_t p = 0; p < detector->n_programs; ++p) {
+            __m256i program = _mm256_loadu_si256((const __m256i *)detector->programs[p].program_id);
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(key, program)) == -1)
+                return detector->programs[p].protocol;
+        }
+    }
+    return YUREI_PROTOCOL_NONE;
+}
+#endif
+
+static void report(const char *label, size_t n_programs, size_t n_txs, size_t keys, size_t iterations,
+                   uint64_t elapsed_ns, uint64_t checksum) {
+    double per_tx = (double)elapsed_ns / (double)(n_txs * iterations);
+    double per_key = (double)elapsed_ns / (double)(keys * iterations);
+    printf("%-8s programs=%-3zu %8.1f ns/tx %6.2f ns/key  (checksum %lu)\n", label, n_programs, per_tx, per_key,
+           (unsigned long)checksum);
+}
+
+int main(int argc, char **argv) {
+    size_t n_txs = argc > 1 ? strtoul(argv[1], NULL, 10) : 1024;
+    size_t iterations = argc > 2 ? strtoul(argv[2], NULL, 10) : 200;
+    if (n_txs == 0 || iterations == 0) {
+        fprintf(stderr, "usage: %s [transactions] [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    uint8_t programs[YUREI_DETECTOR_MAX_PROGRAMS][32];
+    for (size_t p = 0; p < YUREI_DETECTOR_MAX_PROGRAMS; ++p)
+        random_key(programs[p]);
+
+    // Keys live in one pool, like the views the scanner hands out.
+    tx_t *txs = calloc(n_txs, sizeof(*txs));
+    uint8_t *pool = malloc(n_txs * MAX_KEYS * 32);
+    if (!txs || !pool) {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+    size_t total_keys = 0;
+    for (size_t t = 0; t < n_txs; ++t) {
+        tx_t *tx = &txs[t];
+        tx->n_keys = MIN_KEYS + (size_t)(next_random() % (MAX_KEYS - MIN_KEYS + 1));
+        for (size_t k = 0; k < tx->n_keys; ++k) {
+            uint8_t *key = pool + (t * MAX_KEYS + k) * 32;
+            random_key(key);
+            tx->keys[k] = key;
+            tx->lens[k] = 32;
+        }
+        total_keys += tx->n_keys;
+    }
+
+    const size_t sizes[] = {2, 8, 16, 50, 64};
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        size_t n_programs = sizes[s];
+        yurei_protocol_detector_t detector;
+        protocol_detector_init(&detector);
+        for (size_t p = 0; p < n_programs; ++p)
+            protocol_detector_add(&detector, programs[p], p % 2 ? YUREI_PROTOCOL_RAYDIUM : YUREI_PROTOCOL_PUMPFUN);
+
+        // Plant one watched program per matching transaction.
+        rng_state = 0x2545F4914F6CDD1Dull;
+        size_t keys_scanned = 0;
+        for (size_t t = 0; t < n_txs; ++t) {
+            tx_t *tx = &txs[t];
+            for (size_t k = 0; k < tx->n_keys; ++k)
+                tx->keys[k] = pool + (t * MAX_KEYS + k) * 32;
+            size_t hit = tx->n_keys;
+            if (next_random() % 10 != 0) {
+                hit = (size_t)(next_random() % tx->n_keys);
+                tx->keys[hit] = programs[next_random() % n_programs];
+            }
+            keys_scanned += hit < tx->n_keys ? hit + 1 : tx->n_keys;
+        }
+
+        uint64_t checksum = 0;
+        uint64_t start = now_ns();
+        for (size_t it = 0; it < iterations; ++it) {
+            for (size_t t = 0; t < n_txs; ++t)
+                checksum += protocol_detector_match_accounts(&detector, txs[t].keys, txs[t].lens, txs[t].n_keys);
+        }
+        report("registry", n_programs, n_txs, keys_scanned, iterations, now_ns() - start, checksum);
+
+        checksum = 0;
+        start = now_ns();
+        for (size_t it = 0; it < iterations; ++it) {
+            for (size_t t = 0; t < n_txs; ++t)
+                checksum += match_linear(&detector, &txs[t]);
+        }
+        report("linear", n_programs, n_txs, keys_scanned, iterations, now_ns() - start, checksum);
+#if defined(__AVX2__)
+        checksum = 0;
+        start = now_ns();
+        for (size_t it = 0; it < iterations; ++it) {
+            for (size_t t = 0; t < n_txs; ++t)
+                checksum += match_vector(&detector, &txs[t]);
+        }
+        report("vector", n_programs, n_txs, keys_scanned, iterations, now_ns() - start, checksum);
+#endif
+    }
+    printf("%zu transactions, %zu account keys, %zu iterations\n", n_txs, total_keys, iterations);
+
+    free(pool);
+    free(txs);
+    return 0;
+}
@@ -0,0 +1,231 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+// Compares the hand-written wire scanner against the generated protobuf-c
+// decoder (malloc and arena allocators) on recorded SubscribeUpdate traffic.
+//
+// usage: bench_update_decoder [capture-file] [iterations]
+//
+// A capture file is either a segment written by the stream recorder
+// (YUREI_CAPTURE_DIR) or a bare sequence of records, each a little-endian
+// uint32 length followed by one serialized SubscribeUpdate.  Without a file a
+// synthetic PumpFun-like transaction update is generated.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pb_arena.h"
+#include "stream_recorder.h"
+#include "update_scanner.h"
+
+#include "geyser.pb-c.h"
+
+typedef struct {
+    uint8_t *data;
+    size_t len;
+} sample_t;
+
+typedef struct {
+    sample_t *items;
+    size_t count;
+    size_t bytes;
+} corpus_t;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static bool corpus_add(corpus_t *corpus, const uint8_t *data, size_t len) {
+    sample_t *grown = realloc(corpus->items, (corpus->count + 1) * sizeof(sample_t));
+    if (!grown)
+        return false;
+    corpus->items = grown;
+    uint8_t *copy = malloc(len ? len : 1);
+    if (!copy)
+        return false;
+    memcpy(copy, data, len);
+    corpus->items[corpus->count].data = copy;
+    corpus->items[corpus->count].len = len;
+    corpus->count++;
+    corpus->bytes += len;
+    return true;
+}
+
+static bool load_capture(const char *path, corpus_t *corpus) {
+    yurei_capture_reader_t reader;
+    if (capture_reader_open(&reader, path)) {
+        int64_t recv_ns;
+        const uint8_t *data;
+        size_t len;
+        while (capture_reader_next(&reader, &recv_ns, &data, &len))
+            corpus_add(corpus, data, len);
+        capture_reader_close(&reader);
+        return corpus->count > 0;
+    }
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        perror(path);
+        return false;
+    }
+    uint8_t header[4];
+    uint8_t *buffer = NULL;
+    size_t cap = 0;
+    while (fread(header, 1, sizeof(header), fp) == sizeof(header)) {
+        size_t len = (size_t)header[0] | ((size_t)header[1] << 8) | ((size_t)header[2] << 16) | ((size_t)header[3] << 24);
+        if (len > cap) {
+            uint8_t *grown = realloc(buffer, len);
+            if (!grown)
+                break;
+            buffer = grown;
+            cap = len;
+        }
+        if (fread(buffer, 1, len, fp) != len)
+            break;
+        corpus_add(corpus, buffer, len);
+    }
+    free(buffer);
+    fclose(fp);
+    return corpus->count > 0;
+}
+
+static void synthesize(corpus_t *corpus) {
+    uint8_t keys[24][32];
+    ProtobufCBinaryData key_data[24];
+    for (size_t k = 0; k < 24; ++k) {
+        for (size_t i = 0; i < 32; ++i)
+            keys[k][i] = (uint8_t)(k * 31 + i * 7);
+        key_data[k].data = keys[k];
+        key_data[k].len = 32;
+    }
+    uint8_t signature[64];
+    memset(signature, 0x5A, sizeof(signature));
+    ProtobufCBinaryData sig = {sizeof(signature), signature};
+
+    char log_storage[40][160];
+    char *logs[40];
+    for (size_t i = 0; i < 40; ++i) {
+        snprintf(log_storage[i], sizeof(log_storage[i]),
+                 i % 5 == 0 ? "Program data: vdt/007mYe4AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA%zu"
+                            : "Program 6EF8rrecthR5Dkzon8Nwu78hRvfCKubJ14M5uBEwF6P consumed %zu of 200000 compute units",
+                 i);
+        logs[i] = log_storage[i];
+    }
+    uint64_t balances[24];
+    for (size_t i = 0; i < 24; ++i)
+        balances[i] = 1000000000ull + i;
+
+    Solana__Storage__ConfirmedBlock__Message message = SOLANA__STORAGE__CONFIRMED_BLOCK__MESSAGE__INIT;
+    message.account_keys = key_data;
+    message.n_account_keys = 24;
+    Solana__Storage__ConfirmedBlock__Transaction transaction = SOLANA__STORAGE__CONFIRMED_BLOCK__TRANSACTION__INIT;
+    transaction.signatures = &sig;
+    transaction.n_signatures = 1;
+    transaction.message = &message;
+    Solana__Storage__ConfirmedBlock__TransactionStatusMeta meta = SOLANA__STORAGE__CONFIRMED_BLOCK__TRANSACTION_STATUS_META__INIT;
+    meta.log_messages = logs;
+    meta.n_log_messages = 40;
+    meta.pre_balances = balances;
+    meta.n_pre_balances = 24;
+    meta.post_balances = balances;
+    meta.n_post_balances = 24;
+    Geyser__SubscribeUpdateTransactionInfo info = GEYSER__SUBSCRIBE_UPDATE_TRANSACTION_INFO__INIT;
+    info.has_signature = 1;
+    info.signature = sig;
+    info.transaction = &transaction;
+    info.meta = &meta;
+    Geyser__SubscribeUpdateTransaction tx_update = GEYSER__SUBSCRIBE_UPDATE_TRANSACTION__INIT;
+    tx_update.transaction = &info;
+    tx_update.has_slot = 1;
+    tx_update.slot = 301234567;
+    Geyser__SubscribeUpdate update = GEYSER__SUBSCRIBE_UPDATE__INIT;
+    update.update_oneof_case = GEYSER__SUBSCRIBE_UPDATE__UPDATE_ONEOF_TRANSACTION;
+    update.transaction = &tx_update;
+
+    size_t len = geyser__subscribe_update__get_packed_size(&update);
+    uint8_t *buffer = malloc(len);
+    if (!buffer)
+        return;
+    geyser__subscribe_update__pack(&update, buffer);
+    corpus_add(corpus, buffer, len);
+    free(buffer);
+}
+
+static void report(const char *name, const corpus_t *corpus, size_t iterations, uint64_t elapsed_ns, uint64_t checksum) {
+    double messages = (double)corpus->count * (double)iterations;
+    double seconds = (double)elapsed_ns / 1e9;
+    printf("%-20s %10.1f ns/msg %10.1f MB/s  (checksum %lu)\n",
+           name,
+           (double)elapsed_ns / messages,
+           (double)corpus->bytes * (double)iterations / seconds / 1e6,
+           (unsigned long)checksum);
+}
+
+int main(int argc, char **argv) {
+    corpus_t corpus = {0};
+    if (argc > 1 && strcmp(argv[1], "-") != 0) {
+        if (!load_capture(argv[1], &corpus)) {
+            fprintf(stderr, "no records in %s\n", argv[1]);
+            return 1;
+        }
+    } else {
+        synthesize(&corpus);
+    }
+    size_t iterations = argc > 2 ? strtoul(argv[2], NULL, 10) : 0;
+    if (iterations == 0)
+        iterations = corpus.count >= 10000 ? 5 : 200000 / corpus.count + 1;
+    printf("%zu messages, %zu bytes, %zu iterations\n", corpus.count, corpus.bytes, iterations);
+
+    static yurei_tx_view_t view;
+    uint64_t checksum = 0;
+    uint64_t start = now_ns();
+    for (size_t it = 0; it < iterations; ++it) {
+        for (size_t i = 0; i < corpus.count; ++i) {
+            if (update_scanner_scan(corpus.items[i].data, corpus.items[i].len, &view))
+                checksum += view.n_account_keys + view.n_log_messages;
+        }
+    }
+    report("scanner", &corpus, iterations, now_ns() - start, checksum);
+
+    checksum = 0;
+    start = now_ns();
+    for (size_t it = 0; it < iterations; ++it) {
+        for (size_t i = 0; i < corpus.count; ++i) {
+            Geyser__SubscribeUpdate *update = geyser__subscribe_update__unpack(NULL, corpus.items[i].len, corpus.items[i].data);
+            if (!update)
+                continue;
+            checksum += update->update_oneof_case;
+            geyser__subscribe_update__free_unpacked(update, NULL);
+        }
+    }
+    report("generated (malloc)", &corpus, iterations, now_ns() - start, checksum);
+
+    yurei_pb_arena_t arena;
+    if (!pb_arena_init(&arena, 0))
+        return 1;
+    checksum = 0;
+    start = now_ns();
+    for (size_t it = 0; it < iterations; ++it) {
+        for (size_t i = 0; i < corpus.count; ++i) {
+            Geyser__SubscribeUpdate *update = geyser__subscribe_update__unpack(&arena.allocator, corpus.items[i].len, corpus.items[i].data);
+            if (update)
+                checksum += update->update_oneof_case;
+            pb_arena_reset(&arena);
+        }
+    }
+    report("generated (arena)", &corpus, iterations, now_ns() - start, checksum);
+    pb_arena_destroy(&arena);
+
+    for (size_t i = 0; i < corpus.count; ++i)
+        free(corpus.items[i].data);
+    free(corpus.items);
+    return 0;
+}
@@ -0,0 +1,53 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#ifndef YUREI_ACCOUNT_DECODER_H
+#define YUREI_ACCOUNT_DECODER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "yurei_event.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define YUREI_ACCOUNT_MAX_SLICES 5
+#define YUREI_RAYDIUM_AMM_INFO_SIZE 752
+
+// Byte range of account data requested through accounts_data_slice
+typedef struct {
+    uint32_t offset;
+    uint32_t length;
+} yurei_data_slice_t;
+
+// Fixed account layout: the slices the server is asked for, concatenated in
+// order into the data the decoder receives.
+typedef struct {
+    yurei_data_slice_t slices[YUREI_ACCOUNT_MAX_SLICES];
+    size_t n_slices;
+    // Bytes below which an update cannot be decoded
+    size_t min_len;
+} yurei_account_layout_t;
+
+// Anchor discriminator of BondingCurve accounts (sha256("account:BondingCurve"))
+extern const uint8_t account_decoder_pumpfun_curve_discriminator[8];
+
+extern const yurei_account_layout_t account_layout_pumpfun_curve;
+extern const yurei_account_layout_t account_layout_raydium_pool;
+
+// Decode sliced account data; `pubkey` is the account address.  Slot and
+// write version are left for the caller.
+bool account_decode_pumpfun_curve(const uint8_t *pubkey, const uint8_t *data, size_t len,
+                                  yurei_pumpfun_curve_t *out);
+bool account_decode_raydium_pool(const uint8_t *pubkey, const uint8_t *data, size_t len,
+                                 yurei_raydium_pool_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
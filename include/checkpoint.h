@@ -0,0 +1,84 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#ifndef YUREI_CHECKPOINT_H
+#define YUREI_CHECKPOINT_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct pg_conn;
+
+// Watermark slots, one per source: a shard of the subscription (its
+// programs at its commitment level), shared by that shard's streams on
+// every endpoint because dedup merges them.
+#define YUREI_CHECKPOINT_SOURCES 16
+
+// Committed slots.  `sources` holds, per source, the highest slot whose
+// events are all in Postgres; a reconnecting stream resumes from its own
+// source so a shard that trails the others keeps its backlog.  `slot` is
+// the lowest of them, the point every source has reached; it is what gets
+// persisted and what a source without events of its own resumes from.
+// 0 means nothing committed or loaded yet.
+typedef struct {
+    _Atomic uint64_t slot;
+    _Atomic uint64_t sources[YUREI_CHECKPOINT_SOURCES];
+} yurei_checkpoint_t;
+
+static inline void checkpoint_init(yurei_checkpoint_t *cp, uint64_t slot) {
+    atomic_init(&cp->slot, slot);
+    for (size_t i = 0; i < YUREI_CHECKPOINT_SOURCES; ++i)
+        atomic_init(&cp->sources[i], 0);
+}
+
+static inline uint64_t checkpoint_slot(yurei_checkpoint_t *cp) {
+    return atomic_load_explicit(&cp->slot, memory_order_acquire);
+}
+
+// Monotonic: an older slot never moves the checkpoint back.
+static inline void checkpoint_advance(yurei_checkpoint_t *cp, uint64_t slot) {
+    uint64_t current = atomic_load(&cp->slot);
+    while (slot > current) {
+        if (atomic_compare_exchange_weak(&cp->slot, &current, slot))
+            break;
+    }
+}
+
+// Where `source` resumes: its own watermark, or the shared one until it
+// has committed something.
+static inline uint64_t checkpoint_source_slot(yurei_checkpoint_t *cp, size_t source) {
+    uint64_t slot = source < YUREI_CHECKPOINT_SOURCES
+        ? atomic_load_explicit(&cp->sources[source], memory_order_acquire)
+        : 0;
+    return slot ? slot : checkpoint_slot(cp);
+}
+
+static inline void checkpoint_advance_source(yurei_checkpoint_t *cp, size_t source, uint64_t slot) {
+    if (source >= YUREI_CHECKPOINT_SOURCES)
+        return;
+    uint64_t current = atomic_load(&cp->sources[source]);
+    while (slot > current) {
+        if (atomic_compare_exchange_weak(&cp->sources[source], &current, slot))
+            break;
+    }
+}
+
+// Reads the persisted checkpoint `name` from yurei_checkpoints.  Returns
+// false when there is none or the database is unreachable.
+bool checkpoint_load(const char *db_url, const char *name, uint64_t *slot);
+
+// Upserts checkpoint `name` on an open connection.
+bool checkpoint_store(struct pg_conn *conn, const char *name, uint64_t slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,30 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#ifndef YUREI_CONTROL_SOCKET_H
+#define YUREI_CONTROL_SOCKET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct control_socket control_socket_t;
+
+// Handles one command line (without the trailing newline) and writes a
+// single-line reply.
+typedef void (*control_handler_fn)(void *ctx, char *command, char *reply, size_t reply_len);
+
+// Listens on a unix stream socket at `path` and serves one client at a time
+// from a background thread, one command per line.
+control_socket_t *control_socket_start(const char *path, control_handler_fn handler, void *ctx);
+void control_socket_stop(control_socket_t *sock);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -7,6 +7,7 @@
 
 #include <stdbool.h>
 
+#include "checkpoint.h"
 #include "event_queue.h"
 #include "yurei_config.h"
 
@@ -17,6 +18,8 @@ extern "C" {
 typedef struct {
     yurei_event_queue_t *queue;
     const yurei_config_t *config;
+    // Advanced and persisted after every fully committed flush (optional)
+    yurei_checkpoint_t *checkpoint;
 } db_writer_params_t;
 
 typedef struct db_writer db_writer_t;
@@ -0,0 +1,43 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#ifndef YUREI_DEDUP_SET_H
+#define YUREI_DEDUP_SET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct yurei_dedup_set yurei_dedup_set_t;
+
+// Bounded set of (signature, slot) pairs used to merge several redundant
+// streams.  Memory stays fixed at `capacity` entries: the oldest slots are
+// recycled first, and recycling an entry still inside `slot_window` slots of
+// the newest slot seen is counted as an eviction.
+yurei_dedup_set_t *dedup_set_create(size_t capacity, uint64_t slot_window);
+void dedup_set_destroy(yurei_dedup_set_t *set);
+
+// Records a sighting.  Returns true the first time a pair is inserted.  For
+// duplicates, `first_source` and `first_ns` (either may be NULL) receive the
+// source and timestamp stored so far.  Sightings may be inserted out of
+// arrival order, so a duplicate with an earlier `now_ns` replaces the stored
+// arrival; callers detect this by `*first_ns > now_ns`.
+bool dedup_set_insert(yurei_dedup_set_t *set,
+                      const uint8_t *signature,
+                      size_t signature_len,
+                      uint64_t slot,
+                      uint32_t source,
+                      uint64_t now_ns,
+                      uint32_t *first_source,
+                      uint64_t *first_ns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
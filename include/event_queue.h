@@ -16,9 +16,29 @@ extern "C" {
 
 typedef struct yurei_event_queue yurei_event_queue_t;
 
+// Growable list of events produced while decoding a single message.  Storage
+// is kept across resets so steady-state decoding does not allocate.
+typedef struct {
+    yurei_event_t *events;
+    size_t count;
+    size_t capacity;
+} yurei_event_batch_t;
+
+void event_batch_init(yurei_event_batch_t *batch);
+bool event_batch_append(yurei_event_batch_t *batch, const yurei_event_t *event);
+void event_batch_reset(yurei_event_batch_t *batch);
+void event_batch_free(yurei_event_batch_t *batch);
+
 yurei_event_queue_t *event_queue_create(size_t capacity);
 void event_queue_destroy(yurei_event_queue_t *queue);
 bool event_queue_push(yurei_event_queue_t *queue, const yurei_event_t *event);
+bool event_queue_push_batch(yurei_event_queue_t *queue, const yurei_event_t *events, size_t count);
+// Adds the lower-priority lane used by historical backfill; the live lane
+// keeps the capacity given to event_queue_create.
+bool event_queue_enable_backfill(yurei_event_queue_t *queue, size_t capacity);
+// Blocks while the backfill lane is full; fails if it was never enabled.
+bool event_queue_push_backfill(yurei_event_queue_t *queue, const yurei_event_t *events, size_t count);
+// Pops from the live lane, or from the backfill lane when it is empty.
 bool event_queue_pop(yurei_event_queue_t *queue, yurei_event_t *event, bool block);
 void event_queue_close(yurei_event_queue_t *queue);
 size_t event_queue_size(yurei_event_queue_t *queue);
@@ -7,6 +7,7 @@
 
 #include <stdbool.h>
 
+#include "checkpoint.h"
 #include "event_queue.h"
 #include "protocol_detector.h"
 #include "yurei_config.h"
@@ -17,11 +18,27 @@ extern "C" {
 
 typedef struct geyser_client geyser_client_t;
 
+// `checkpoint` (optional) is consulted on every (re)connect to resume from
+// the last committed slot.
 geyser_client_t *geyser_client_start(const yurei_config_t *config,
                                      const yurei_protocol_detector_t *detector,
-                                     yurei_event_queue_t *queue);
+                                     yurei_event_queue_t *queue,
+                                     yurei_checkpoint_t *checkpoint);
 void geyser_client_stop(geyser_client_t *client);
 
+// Replaces the watched programs and commitment level of every open stream by
+// sending a new SubscribeRequest on the live call, without reconnecting.  The
+// detector used by the decode path is swapped atomically.  Fails if sharding
+// by program and a newly enabled program has no stream of its own.
+bool geyser_client_update_filters(geyser_client_t *client,
+                                  const yurei_protocol_detector_t *detector,
+                                  yurei_commitment_t commitment);
+
+// Copies out the filters currently in effect.
+void geyser_client_get_filters(geyser_client_t *client,
+                               yurei_protocol_detector_t *detector,
+                               yurei_commitment_t *commitment);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,48 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#ifndef YUREI_INGEST_PIPELINE_H
+#define YUREI_INGEST_PIPELINE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "event_queue.h"
+#include "topology.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Decodes one raw message into zero or more events.  The callback owns
+// `message` and must release it before returning.  `recv_ns` is the
+// monotonic time the message was taken off the wire.
+typedef void (*yurei_ingest_decode_fn)(void *ctx, void *message, uint64_t recv_ns, yurei_event_batch_t *out);
+
+typedef struct yurei_ingest_pipeline yurei_ingest_pipeline_t;
+
+// Starts `workers` decode threads, pinned in turn to the CPUs of `cpus`
+// (optional).  Up to `depth` messages may be in flight between submission
+// and release; events are released to `queue` in submission order
+// regardless of which worker decoded them.
+yurei_ingest_pipeline_t *ingest_pipeline_create(size_t workers,
+                                                size_t depth,
+                                                yurei_event_queue_t *queue,
+                                                yurei_ingest_decode_fn decode,
+                                                const yurei_cpu_list_t *cpus);
+
+// Hands a raw message to the worker pool.  Blocks while `depth` messages are
+// already in flight.  Returns false once the pipeline is stopping, in which
+// case ownership of `message` stays with the caller.
+bool ingest_pipeline_submit(yurei_ingest_pipeline_t *pipeline, void *message, void *ctx, uint64_t recv_ns);
+
+// Drains every submitted message, then joins the workers.
+void ingest_pipeline_destroy(yurei_ingest_pipeline_t *pipeline);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -14,6 +14,38 @@
 extern "C" {
 #endif
 
+#define YUREI_METRICS_MAX_ENDPOINTS 8
+#define YUREI_METRICS_ENDPOINT_NAME 64
+#define YUREI_METRICS_MAX_FILTERS 8
+#define YUREI_METRICS_FILTER_NAME 32
+#define YUREI_HISTOGRAM_BUCKETS 32
+
+// Log2 histogram of microsecond values: bucket 0 holds values below 2us and
+// bucket i holds [2^i, 2^(i+1)) us.
+typedef struct {
+    _Atomic uint64_t buckets[YUREI_HISTOGRAM_BUCKETS];
+    _Atomic uint64_t count;
+    _Atomic uint64_t sum_us;
+    _Atomic uint64_t max_us;
+} yurei_histogram_t;
+
+// Per-endpoint stream racing stats
+typedef struct {
+    char name[YUREI_METRICS_ENDPOINT_NAME];
+    _Atomic uint64_t races_won;
+    _Atomic uint64_t duplicates;
+    yurei_histogram_t arrival_lag_us;
+    // Gauge from the stall watchdog's last head-slot probe
+    _Atomic uint64_t slots_behind_head;
+} yurei_endpoint_metrics_t;
+
+// Updates matched per subscription filter key (SubscribeUpdate.filters)
+typedef struct {
+    char name[YUREI_METRICS_FILTER_NAME];
+    _Atomic uint64_t updates;
+    _Atomic uint64_t bytes;
+} yurei_filter_metrics_t;
+
 // Metrics collection for YUREI Agent performance monitoring
 typedef struct {
     // Event counters
@@ -22,19 +54,113 @@ typedef struct {
     _Atomic uint64_t events_raydium;
     _Atomic uint64_t events_dropped;
 
+    // Account state updates
+    _Atomic uint64_t account_updates;
+    _Atomic uint64_t account_decode_errors;
+    _Atomic uint64_t events_pumpfun_curve;
+    _Atomic uint64_t events_raydium_pool;
+
+    // Block ingest: blocks with matching events, and those events
+    _Atomic uint64_t block_updates;
+    _Atomic uint64_t block_events;
+
     // Queue stats
     _Atomic uint64_t queue_pushes;
     _Atomic uint64_t queue_pops;
     _Atomic uint64_t queue_high_water;
     _Atomic uint64_t queue_overflows;
 
+    // Ingest pipeline stats
+    _Atomic uint64_t pipeline_high_water;
+    _Atomic uint64_t pipeline_stalls;
+
+    // Protobuf arena stats (bytes, max over all decode threads)
+    _Atomic uint64_t arena_high_water;
+    _Atomic uint64_t arena_reserved;
+
+    // Received message layout (single slice is decoded in place)
+    _Atomic uint64_t recv_single_slice;
+    _Atomic uint64_t recv_multi_slice;
+    _Atomic uint64_t recv_copied_bytes;
+    // Message bytes as received and after decompression
+    _Atomic uint64_t recv_wire_bytes;
+    _Atomic uint64_t recv_decoded_bytes;
+    _Atomic uint64_t recv_compressed;
+
+    // Raw stream capture
+    _Atomic uint64_t capture_records;
+    _Atomic uint64_t capture_bytes;
+    _Atomic uint64_t capture_dropped;
+    _Atomic uint64_t capture_segments;
+
+    // Decoder stats
+    _Atomic uint64_t scanner_fallbacks;
+    _Atomic uint64_t decoder_mismatches;
+
+    // Subscribe stream keepalive
+    _Atomic uint64_t pings_sent;
+    _Atomic uint64_t pongs_received;
+    _Atomic uint64_t server_pings;
+    yurei_histogram_t ping_rtt_us;
+
+    // Reconnects: stream end -> first message of the next call
+    _Atomic uint64_t reconnect_failures;
+    yurei_histogram_t reconnect_us;
+
+    // Resumes the provider could not replay in full (SubscribeReplayInfo)
+    _Atomic uint64_t replay_gaps;
+    _Atomic uint64_t replay_gap_slots;
+    _Atomic uint64_t replay_unavailable;
+
+    // Stall watchdog
+    _Atomic uint64_t watchdog_probes;
+    _Atomic uint64_t watchdog_probe_failures;
+    _Atomic uint64_t stall_reconnects;
+
+    // Slot continuity: gaps found past the grace window, the slots they
+    // cover, and gaps replayed or given up on
+    _Atomic uint64_t slot_gaps;
+    _Atomic uint64_t slot_gap_slots;
+    _Atomic uint64_t slot_gaps_repaired;
+    _Atomic uint64_t slot_gaps_unrecoverable;
+
+    // Historical backfill: range size, slots covered so far by all backfill
+    // streams, events they produced, and when the run started (monotonic)
+    _Atomic uint64_t backfill_slots_total;
+    _Atomic uint64_t backfill_slots_done;
+    _Atomic uint64_t backfill_events;
+    _Atomic uint64_t backfill_streams_done;
+    _Atomic uint64_t backfill_started_ns;
+
     // Database stats
     _Atomic uint64_t db_inserts_success;
     _Atomic uint64_t db_inserts_failed;
     _Atomic uint64_t db_batches;
     _Atomic uint64_t db_reconnects;
+    _Atomic uint64_t checkpoint_slot;
+    _Atomic uint64_t checkpoint_held_slot;
+    _Atomic uint64_t slots_confirmed;
+    _Atomic uint64_t slots_finalized;
+    _Atomic uint64_t slots_dead;
+
+    // Endpoint racing stats
+    yurei_endpoint_metrics_t endpoints[YUREI_METRICS_MAX_ENDPOINTS];
+    _Atomic uint64_t n_endpoints;
+    _Atomic uint64_t dedup_evictions;
+
+    // Traffic share per filter key
+    yurei_filter_metrics_t filters[YUREI_METRICS_MAX_FILTERS];
+    _Atomic uint64_t n_filters;
 
-    // Timing (microseconds)
+    // Ingest latency by stage: provider send (SubscribeUpdate.created_at)
+    // -> receive -> event queue push -> pop -> DB commit, and end to end
+    yurei_histogram_t provider_recv_us;
+    yurei_histogram_t recv_enqueue_us;
+    yurei_histogram_t queue_wait_us;
+    yurei_histogram_t dequeue_commit_us;
+    yurei_histogram_t provider_commit_us;
+
+    // Timing (microseconds); event latency is local receive -> commit
     _Atomic uint64_t total_event_latency_us;
     _Atomic uint64_t total_db_latency_us;
 
@@ -48,6 +174,38 @@ extern yurei_metrics_t g_metrics;
 // Initialize metrics
 void metrics_init(void);
 
+// Monotonic clock in nanoseconds
+uint64_t metrics_now_ns(void);
+
+// Wall clock in unix nanoseconds, to compare against provider timestamps
+int64_t metrics_wall_ns(void);
+
+static inline void metrics_histogram_record(yurei_histogram_t *h, uint64_t us) {
+    unsigned bucket = 0;
+    if (us >= 2) {
+        bucket = 63u - (unsigned)__builtin_clzll(us);
+        if (bucket >= YUREI_HISTOGRAM_BUCKETS)
+            bucket = YUREI_HISTOGRAM_BUCKETS - 1;
+    }
+    atomic_fetch_add_explicit(&h->buckets[bucket], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->sum_us, us, memory_order_relaxed);
+    uint64_t current = atomic_load_explicit(&h->max_us, memory_order_relaxed);
+    while (us > current) {
+        if (atomic_compare_exchange_weak(&h->max_us, &current, us))
+            break;
+    }
+}
+
+// Upper bound (us) of the bucket holding the given percentile (0-100)
+uint64_t metrics_histogram_percentile(const yurei_histogram_t *h, double percentile);
+
+// Names an endpoint slot for per-endpoint metrics
+void metrics_register_endpoint(size_t index, const char *name);
+
+// Names a filter key slot for per-filter traffic metrics
+void metrics_register_filter(size_t index, const char *name);
+
 // Increment helpers (thread-safe)
 static inline void metrics_inc_events_total(void) {
     atomic_fetch_add(&g_metrics.events_total, 1);
@@ -61,6 +219,27 @@ static inline void metrics_inc_raydium(void) {
     atomic_fetch_add(&g_metrics.events_raydium, 1);
 }
 
+static inline void metrics_inc_block_update(uint64_t events) {
+    atomic_fetch_add(&g_metrics.block_updates, 1);
+    atomic_fetch_add(&g_metrics.block_events, events);
+}
+
+static inline void metrics_inc_account_update(void) {
+    atomic_fetch_add(&g_metrics.account_updates, 1);
+}
+
+static inline void metrics_inc_account_decode_error(void) {
+    atomic_fetch_add(&g_metrics.account_decode_errors, 1);
+}
+
+static inline void metrics_inc_pumpfun_curve(void) {
+    atomic_fetch_add(&g_metrics.events_pumpfun_curve, 1);
+}
+
+static inline void metrics_inc_raydium_pool(void) {
+    atomic_fetch_add(&g_metrics.events_raydium_pool, 1);
+}
+
 static inline void metrics_inc_dropped(void) {
     atomic_fetch_add(&g_metrics.events_dropped, 1);
 }
@@ -85,6 +264,173 @@ static inline void metrics_inc_queue_overflow(void) {
     atomic_fetch_add(&g_metrics.queue_overflows, 1);
 }
 
+static inline void metrics_update_pipeline_high_water(uint64_t in_flight) {
+    uint64_t current = atomic_load(&g_metrics.pipeline_high_water);
+    while (in_flight > current) {
+        if (atomic_compare_exchange_weak(&g_metrics.pipeline_high_water, &current, in_flight))
+            break;
+    }
+}
+
+static inline void metrics_inc_pipeline_stall(void) {
+    atomic_fetch_add(&g_metrics.pipeline_stalls, 1);
+}
+
+static inline void metrics_update_arena_high_water(uint64_t used, uint64_t reserved) {
+    uint64_t current = atomic_load(&g_metrics.arena_high_water);
+    while (used > current) {
+        if (atomic_compare_exchange_weak(&g_metrics.arena_high_water, &current, used))
+            break;
+    }
+    current = atomic_load(&g_metrics.arena_reserved);
+    while (reserved > current) {
+        if (atomic_compare_exchange_weak(&g_metrics.arena_reserved, &current, reserved))
+            break;
+    }
+}
+
+static inline void metrics_inc_recv_single_slice(void) {
+    atomic_fetch_add(&g_metrics.recv_single_slice, 1);
+}
+
+static inline void metrics_inc_recv_multi_slice(uint64_t copied_bytes) {
+    atomic_fetch_add(&g_metrics.recv_multi_slice, 1);
+    atomic_fetch_add(&g_metrics.recv_copied_bytes, copied_bytes);
+}
+
+static inline void metrics_add_recv_bytes(uint64_t wire_bytes, uint64_t decoded_bytes, bool compressed) {
+    atomic_fetch_add(&g_metrics.recv_wire_bytes, wire_bytes);
+    atomic_fetch_add(&g_metrics.recv_decoded_bytes, decoded_bytes);
+    if (compressed)
+        atomic_fetch_add(&g_metrics.recv_compressed, 1);
+}
+
+static inline void metrics_record_filter_update(size_t index, uint64_t bytes) {
+    if (index >= YUREI_METRICS_MAX_FILTERS)
+        return;
+    atomic_fetch_add(&g_metrics.filters[index].updates, 1);
+    atomic_fetch_add(&g_metrics.filters[index].bytes, bytes);
+}
+
+static inline void metrics_inc_endpoint_won(size_t index) {
+    if (index < YUREI_METRICS_MAX_ENDPOINTS)
+        atomic_fetch_add(&g_metrics.endpoints[index].races_won, 1);
+}
+
+// A later-decoded copy turned out to have been received first
+static inline void metrics_transfer_endpoint_win(size_t from, size_t to) {
+    if (from >= YUREI_METRICS_MAX_ENDPOINTS || to >= YUREI_METRICS_MAX_ENDPOINTS)
+        return;
+    atomic_fetch_sub(&g_metrics.endpoints[from].races_won, 1);
+    atomic_fetch_add(&g_metrics.endpoints[to].races_won, 1);
+}
+
+static inline void metrics_record_endpoint_duplicate(size_t index, uint64_t lag_us) {
+    if (index >= YUREI_METRICS_MAX_ENDPOINTS)
+        return;
+    atomic_fetch_add(&g_metrics.endpoints[index].duplicates, 1);
+    metrics_histogram_record(&g_metrics.endpoints[index].arrival_lag_us, lag_us);
+}
+
+static inline void metrics_inc_dedup_eviction(void) {
+    atomic_fetch_add(&g_metrics.dedup_evictions, 1);
+}
+
+static inline void metrics_add_capture(uint64_t records, uint64_t bytes) {
+    atomic_fetch_add(&g_metrics.capture_records, records);
+    atomic_fetch_add(&g_metrics.capture_bytes, bytes);
+}
+
+static inline void metrics_inc_capture_dropped(void) {
+    atomic_fetch_add(&g_metrics.capture_dropped, 1);
+}
+
+static inline void metrics_inc_capture_segment(void) {
+    atomic_fetch_add(&g_metrics.capture_segments, 1);
+}
+
+static inline void metrics_inc_scanner_fallback(void) {
+    atomic_fetch_add(&g_metrics.scanner_fallbacks, 1);
+}
+
+static inline void metrics_inc_decoder_mismatch(void) {
+    atomic_fetch_add(&g_metrics.decoder_mismatches, 1);
+}
+
+static inline void metrics_inc_ping_sent(void) {
+    atomic_fetch_add(&g_metrics.pings_sent, 1);
+}
+
+static inline void metrics_record_pong(uint64_t rtt_us) {
+    atomic_fetch_add(&g_metrics.pongs_received, 1);
+    metrics_histogram_record(&g_metrics.ping_rtt_us, rtt_us);
+}
+
+static inline void metrics_inc_server_ping(void) {
+    atomic_fetch_add(&g_metrics.server_pings, 1);
+}
+
+static inline void metrics_inc_reconnect_failure(void) {
+    atomic_fetch_add(&g_metrics.reconnect_failures, 1);
+}
+
+static inline void metrics_record_reconnect(uint64_t us) {
+    metrics_histogram_record(&g_metrics.reconnect_us, us);
+}
+
+static inline void metrics_record_replay_gap(uint64_t slots) {
+    atomic_fetch_add(&g_metrics.replay_gaps, 1);
+    atomic_fetch_add(&g_metrics.replay_gap_slots, slots);
+}
+
+static inline void metrics_inc_replay_unavailable(void) {
+    atomic_fetch_add(&g_metrics.replay_unavailable, 1);
+}
+
+static inline void metrics_inc_watchdog_probe(void) {
+    atomic_fetch_add(&g_metrics.watchdog_probes, 1);
+}
+
+static inline void metrics_inc_watchdog_probe_failure(void) {
+    atomic_fetch_add(&g_metrics.watchdog_probe_failures, 1);
+}
+
+static inline void metrics_inc_stall_reconnect(void) {
+    atomic_fetch_add(&g_metrics.stall_reconnects, 1);
+}
+
+static inline void metrics_set_slots_behind_head(size_t index, uint64_t slots) {
+    if (index < YUREI_METRICS_MAX_ENDPOINTS)
+        atomic_store(&g_metrics.endpoints[index].slots_behind_head, slots);
+}
+
+static inline void metrics_record_slot_gap(uint64_t gaps, uint64_t slots) {
+    atomic_fetch_add(&g_metrics.slot_gaps, gaps);
+    atomic_fetch_add(&g_metrics.slot_gap_slots, slots);
+}
+
+static inline void metrics_inc_slot_gap_repaired(void) {
+    atomic_fetch_add(&g_metrics.slot_gaps_repaired, 1);
+}
+
+static inline void metrics_inc_slot_gap_unrecoverable(void) {
+    atomic_fetch_add(&g_metrics.slot_gaps_unrecoverable, 1);
+}
+
+static inline void metrics_start_backfill(uint64_t total_slots) {
+    atomic_store(&g_metrics.backfill_slots_total, total_slots);
+    atomic_store(&g_metrics.backfill_started_ns, metrics_now_ns());
+}
+
+static inline void metrics_add_backfill_progress(uint64_t slots, uint64_t events) {
+    atomic_fetch_add(&g_metrics.backfill_slots_done, slots);
+    atomic_fetch_add(&g_metrics.backfill_events, events);
+}
+
+static inline void metrics_inc_backfill_stream_done(void) {
+    atomic_fetch_add(&g_metrics.backfill_streams_done, 1);
+}
+
 static inline void metrics_inc_db_success(void) {
     atomic_fetch_add(&g_metrics.db_inserts_success, 1);
 }
@@ -101,10 +447,53 @@ static inline void metrics_inc_db_reconnect(void) {
     atomic_fetch_add(&g_metrics.db_reconnects, 1);
 }
 
+static inline void metrics_inc_slot_confirmed(void) {
+    atomic_fetch_add(&g_metrics.slots_confirmed, 1);
+}
+
+static inline void metrics_inc_slot_finalized(void) {
+    atomic_fetch_add(&g_metrics.slots_finalized, 1);
+}
+
+static inline void metrics_inc_slot_dead(void) {
+    atomic_fetch_add(&g_metrics.slots_dead, 1);
+}
+
+static inline void metrics_set_checkpoint_slot(uint64_t slot) {
+    atomic_store(&g_metrics.checkpoint_slot, slot);
+}
+
+// Lowest rolled-back slot the checkpoint is held below; 0 when none.
+static inline void metrics_set_checkpoint_held_slot(uint64_t slot) {
+    atomic_store(&g_metrics.checkpoint_held_slot, slot);
+}
+
 static inline void metrics_add_event_latency(uint64_t us) {
     atomic_fetch_add(&g_metrics.total_event_latency_us, us);
 }
 
+static inline void metrics_record_provider_latency(uint64_t us) {
+    metrics_histogram_record(&g_metrics.provider_recv_us, us);
+}
+
+static inline void metrics_record_enqueue_latency(uint64_t us) {
+    metrics_histogram_record(&g_metrics.recv_enqueue_us, us);
+}
+
+static inline void metrics_record_queue_wait(uint64_t us) {
+    metrics_histogram_record(&g_metrics.queue_wait_us, us);
+}
+
+// One committed row: dequeue -> commit, local receive -> commit and, when
+// the provider stamped the update, provider send -> commit
+static inline void metrics_record_commit_latency(uint64_t dequeue_us, uint64_t recv_us, bool has_provider,
+                                                 uint64_t provider_us) {
+    metrics_histogram_record(&g_metrics.dequeue_commit_us, dequeue_us);
+    metrics_add_event_latency(recv_us);
+    if (has_provider)
+        metrics_histogram_record(&g_metrics.provider_commit_us, provider_us);
+}
+
 static inline void metrics_add_db_latency(uint64_t us) {
     atomic_fetch_add(&g_metrics.total_db_latency_us, us);
 }
@@ -0,0 +1,45 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#ifndef YUREI_PB_ARENA_H
+#define YUREI_PB_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <protobuf-c/protobuf-c.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct yurei_pb_arena_chunk yurei_pb_arena_chunk_t;
+
+// Bump allocator handed to protobuf-c unpack calls.  `free` is a no-op; all
+// memory is reclaimed at once by pb_arena_reset(), which only rewinds the
+// cursor so chunks grown during a burst are reused by later updates.
+typedef struct {
+    ProtobufCAllocator allocator;
+    yurei_pb_arena_chunk_t *head;
+    yurei_pb_arena_chunk_t *current;
+    size_t chunk_size;
+    size_t used;
+    size_t reserved;
+    size_t high_water;
+} yurei_pb_arena_t;
+
+bool pb_arena_init(yurei_pb_arena_t *arena, size_t chunk_size);
+void *pb_arena_alloc(yurei_pb_arena_t *arena, size_t size);
+void pb_arena_reset(yurei_pb_arena_t *arena);
+void pb_arena_destroy(yurei_pb_arena_t *arena);
+
+// Arena owned by the calling thread, created on first use and released when
+// the thread exits.  Returns NULL if the arena could not be allocated.
+yurei_pb_arena_t *pb_arena_thread_local(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
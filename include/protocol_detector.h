@@ -18,29 +18,79 @@ extern "C" {
 typedef enum {
     YUREI_PROTOCOL_NONE = 0,
     YUREI_PROTOCOL_PUMPFUN,
-    YUREI_PROTOCOL_RAYDIUM
+    YUREI_PROTOCOL_RAYDIUM,
+    YUREI_PROTOCOL_COUNT
 } yurei_protocol_t;
 
+#define YUREI_PROTOCOL_BIT(proto) (1u << (unsigned)(proto))
+#define YUREI_PROTOCOL_ALL 0xFFFFFFFFu
+
+// Registry capacity.  The lookup table has 16 slots per program, so even a
+// full registry fills at most 1/16 of it: nearly every account key that is
+// not watched lands on a free slot and costs one byte load, and the probe
+// stays flat as programs are added.
+#define YUREI_DETECTOR_MAX_PROGRAMS 64
+#define YUREI_DETECTOR_TABLE_BITS 10
+#define YUREI_DETECTOR_TABLE_SIZE (1u << YUREI_DETECTOR_TABLE_BITS)
+
+// One watched program and the protocol whose parser handles it.  Several
+// programs may map to the same protocol.
 typedef struct {
     uint8_t program_id[32];
-    bool enabled;
-} yurei_protocol_pattern_t;
+    yurei_protocol_t protocol;
+} yurei_protocol_program_t;
 
+// Plain value type: filter snapshots copy it whole.  `programs` keeps the
+// registration order; the table is an open-addressing index over them keyed
+// on the first 8 bytes of the program id, where `slot_program` holds the
+// program's index + 1 and 0 marks a free slot.
 typedef struct {
-    yurei_protocol_pattern_t pumpfun;
-    yurei_protocol_pattern_t raydium;
+    uint64_t slot_prefix[YUREI_DETECTOR_TABLE_SIZE];
+    uint8_t slot_program[YUREI_DETECTOR_TABLE_SIZE];
+    yurei_protocol_program_t programs[YUREI_DETECTOR_MAX_PROGRAMS];
+    size_t n_programs;
 } yurei_protocol_detector_t;
 
-void protocol_detector_init(yurei_protocol_detector_t *detector,
-                            const uint8_t pumpfun_program[32], bool pumpfun_enabled,
-                            const uint8_t raydium_program[32], bool raydium_enabled);
+// Starts an empty registry.
+void protocol_detector_init(yurei_protocol_detector_t *detector);
+
+// Watches `program_id` with `protocol`'s handler; a program already present
+// is moved to the new protocol.  Fails when the registry is full.
+bool protocol_detector_add(yurei_protocol_detector_t *detector,
+                           const uint8_t program_id[32],
+                           yurei_protocol_t protocol);
+
+// Returns false when the program was not watched.
+bool protocol_detector_remove(yurei_protocol_detector_t *detector, const uint8_t program_id[32]);
+
+// Drops every program of `protocol`; returns how many were removed.
+size_t protocol_detector_remove_protocol(yurei_protocol_detector_t *detector, yurei_protocol_t protocol);
 
+// Protocol of one 32-byte key, YUREI_PROTOCOL_NONE when it is not watched.
+yurei_protocol_t protocol_detector_lookup(const yurei_protocol_detector_t *detector, const uint8_t key[32]);
+
+// Whether any program of `protocol` is watched.
+bool protocol_detector_has(const yurei_protocol_detector_t *detector, yurei_protocol_t protocol);
+
+// Fills `out` with up to `max` program ids of `protocol` in registration
+// order and returns the number written.
+size_t protocol_detector_programs(const yurei_protocol_detector_t *detector,
+                                  yurei_protocol_t protocol,
+                                  const uint8_t **out,
+                                  size_t max);
+
+// Protocol of the first account key that belongs to a watched program.
 yurei_protocol_t protocol_detector_match_accounts(const yurei_protocol_detector_t *detector,
                                                   const uint8_t *const *accounts,
                                                   const size_t *account_lens,
                                                   size_t n_accounts);
 
-bool protocol_detector_match_program(const yurei_protocol_pattern_t *pattern,
+const char *protocol_detector_name(yurei_protocol_t protocol);
+
+// Parses a name returned by protocol_detector_name (other than "none").
+bool protocol_detector_parse_name(const char *name, yurei_protocol_t *out);
+
+bool protocol_detector_match_program(const yurei_protocol_program_t *program,
                                      const uint8_t *data,
                                      size_t len);
 
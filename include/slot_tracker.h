@@ -0,0 +1,44 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#ifndef YUREI_SLOT_TRACKER_H
+#define YUREI_SLOT_TRACKER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct yurei_slot_tracker yurei_slot_tracker_t;
+
+// Missing slots [start, end)
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+} yurei_slot_gap_t;
+
+// Slot continuity check over a bitmap ring of `window` slots (rounded up to
+// a power of two, at least twice `grace_slots`).  A slot is accounted for
+// once it is observed or a later slot names a parent past it (the leader
+// skipped it).  Slots still unaccounted for `grace_slots` behind the newest
+// one are gaps and go to a repair queue of up to `max_gaps` entries.
+yurei_slot_tracker_t *slot_tracker_create(size_t window, uint64_t grace_slots, size_t max_gaps);
+void slot_tracker_destroy(yurei_slot_tracker_t *tracker);
+
+// Marks `slot` and, when `parent` is non-zero, every slot between the two.
+// Tracking starts at the first slot observed; slots already judged are
+// ignored.  Thread-safe.
+void slot_tracker_observe(yurei_slot_tracker_t *tracker, uint64_t slot, uint64_t parent);
+
+// Takes the oldest queued gap once a later slot has closed it.
+bool slot_tracker_next_gap(yurei_slot_tracker_t *tracker, yurei_slot_gap_t *gap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
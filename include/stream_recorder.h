@@ -0,0 +1,58 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#ifndef YUREI_STREAM_RECORDER_H
+#define YUREI_STREAM_RECORDER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Capture segment layout: the 8-byte magic "YUREICAP" followed by records of
+// a little-endian uint64 receive time (unix nanoseconds), a little-endian
+// uint32 length and one serialized SubscribeUpdate.
+#define YUREI_CAPTURE_MAGIC "YUREICAP"
+#define YUREI_CAPTURE_MAGIC_LEN 8
+#define YUREI_CAPTURE_RECORD_HEADER 12
+
+typedef struct yurei_stream_recorder yurei_stream_recorder_t;
+
+// Starts the writer thread.  Records are staged in a `buffer_bytes` ring
+// and written to `dir`/yurei-<start>-<seq>.cap, moving to a new segment once
+// one reaches `segment_bytes`.
+yurei_stream_recorder_t *stream_recorder_create(const char *dir, size_t segment_bytes, size_t buffer_bytes);
+
+// Copies one message into the ring.  Never waits for the disk: when the
+// ring is full the record is dropped (and counted) and false is returned.
+bool stream_recorder_write(yurei_stream_recorder_t *recorder, int64_t recv_unix_ns, const uint8_t *data, size_t len);
+
+// Writes out everything staged, closes the segment and joins the writer.
+void stream_recorder_destroy(yurei_stream_recorder_t *recorder);
+
+// Sequential reader over one segment file.
+typedef struct {
+    FILE *fp;
+    uint8_t *buffer;
+    size_t capacity;
+} yurei_capture_reader_t;
+
+// Opens a segment and checks its magic.
+bool capture_reader_open(yurei_capture_reader_t *reader, const char *path);
+
+// Reads the next record; `*data` stays valid until the next call.  Returns
+// false at the end of the file or on a truncated record.
+bool capture_reader_next(yurei_capture_reader_t *reader, int64_t *recv_unix_ns, const uint8_t **data, size_t *len);
+
+void capture_reader_close(yurei_capture_reader_t *reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,43 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#ifndef YUREI_TOPOLOGY_H
+#define YUREI_TOPOLOGY_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define YUREI_MAX_CPUS 256
+
+// Ordered list of CPU ids; empty means "leave the thread where it is".
+typedef struct {
+    uint16_t cpus[YUREI_MAX_CPUS];
+    size_t count;
+} yurei_cpu_list_t;
+
+// Parses a Linux-style CPU list such as "2,4-7".  An empty string yields an
+// empty list.
+bool topology_parse_cpus(const char *list, yurei_cpu_list_t *out);
+
+// Pins `thread` to the single CPU `cpus[index % count]`, for spreading a
+// pool of threads over dedicated cores.
+bool topology_pin_thread(pthread_t thread, const yurei_cpu_list_t *cpus, size_t index);
+
+// Lets `thread` run on every CPU of the list.
+bool topology_bind_thread(pthread_t thread, const yurei_cpu_list_t *cpus);
+
+// Reads the CPU set the calling thread may run on.
+bool topology_current_cpus(yurei_cpu_list_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
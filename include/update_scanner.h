@@ -0,0 +1,116 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#ifndef YUREI_UPDATE_SCANNER_H
+#define YUREI_UPDATE_SCANNER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define YUREI_TX_MAX_ACCOUNTS 256
+#define YUREI_TX_MAX_LOGS 512
+#define YUREI_UPDATE_MAX_FILTERS 8
+
+// SubscribeUpdate.update_oneof field numbers (geyser.proto).
+typedef enum {
+    YUREI_UPDATE_NONE = 0,
+    YUREI_UPDATE_ACCOUNT = 2,
+    YUREI_UPDATE_SLOT = 3,
+    YUREI_UPDATE_TRANSACTION = 4,
+    YUREI_UPDATE_BLOCK = 5,
+    YUREI_UPDATE_PING = 6,
+    YUREI_UPDATE_BLOCK_META = 7,
+    YUREI_UPDATE_ENTRY = 8,
+    YUREI_UPDATE_PONG = 9,
+    YUREI_UPDATE_TRANSACTION_STATUS = 10
+} yurei_update_kind_t;
+
+// The subset of a transaction update the pipeline consumes.  Every pointer
+// borrows from the buffer that was scanned (or from the unpacked message for
+// the generated decoder) and is only valid while that buffer is alive.  Log
+// lines are not NUL-terminated.
+typedef struct {
+    yurei_update_kind_t kind;
+    // Serialized size of the whole update
+    size_t encoded_len;
+    // Subscription filter keys the update matched (names are not
+    // NUL-terminated; extra keys past the limit are dropped)
+    size_t n_filters;
+    const char *filters[YUREI_UPDATE_MAX_FILTERS];
+    size_t filter_lens[YUREI_UPDATE_MAX_FILTERS];
+    // SubscribeUpdate.created_at: when the provider sent the update, in
+    // unix nanoseconds
+    bool has_created_at;
+    int64_t created_at_ns;
+    bool has_slot;
+    uint64_t slot;
+    const uint8_t *signature;
+    size_t signature_len;
+    // Position of the transaction in its block
+    bool has_tx_index;
+    uint64_t tx_index;
+    size_t n_account_keys;
+    const uint8_t *account_keys[YUREI_TX_MAX_ACCOUNTS];
+    size_t account_key_lens[YUREI_TX_MAX_ACCOUNTS];
+    size_t n_log_messages;
+    const char *log_messages[YUREI_TX_MAX_LOGS];
+    size_t log_message_lens[YUREI_TX_MAX_LOGS];
+    bool truncated;
+    // SubscribeUpdatePong.id echoed back for our SubscribeRequestPing
+    int32_t pong_id;
+    // SubscribeUpdateSlot (slot itself goes to has_slot/slot)
+    uint64_t parent_slot;
+    bool has_parent_slot;
+    int32_t slot_status;
+    // SubscribeUpdateAccount (slot goes to has_slot/slot); data is whatever
+    // accounts_data_slice selected
+    const uint8_t *account_pubkey;
+    size_t account_pubkey_len;
+    const uint8_t *account_owner;
+    size_t account_owner_len;
+    const uint8_t *account_data;
+    size_t account_data_len;
+    uint64_t write_version;
+    // SubscribeUpdateBlock: block time (unix seconds) and the raw block body
+    // the transactions are iterated from
+    bool has_block_time;
+    int64_t block_time;
+    const uint8_t *block_data;
+    size_t block_len;
+} yurei_tx_view_t;
+
+// Walks the transactions of a block update one at a time.
+typedef struct {
+    const uint8_t *pos;
+    const uint8_t *end;
+    bool malformed;
+} yurei_block_cursor_t;
+
+// Walks the SubscribeUpdate -> SubscribeUpdateTransaction ->
+// TransactionStatusMeta path of a serialized update without allocating and
+// skips every other field.  Returns false on malformed wire data.  For
+// other updates only `kind`, the size, the filter keys and created_at are
+// filled in,
+// plus the pong id, the slot fields of slot updates, the account fields of
+// account updates, and slot, parent, time and body of block updates.
+bool update_scanner_scan(const uint8_t *data, size_t len, yurei_tx_view_t *out);
+
+// Starts iterating a block view produced by update_scanner_scan.
+void update_scanner_block_begin(const yurei_tx_view_t *block, yurei_block_cursor_t *cursor);
+
+// Scans the next transaction of the block into `out` (kind TRANSACTION,
+// with the block's slot, time and created_at).  Returns false at the end of the block
+// or on malformed data, which also sets cursor->malformed.
+bool update_scanner_block_next(yurei_block_cursor_t *cursor, const yurei_tx_view_t *block, yurei_tx_view_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
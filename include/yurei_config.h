@@ -9,31 +9,151 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "protocol_detector.h"
+#include "topology.h"
+
 #define YUREI_ENDPOINT_MAX 256
 #define YUREI_AUTHORITY_MAX 128
 #define YUREI_DB_URL_MAX 512
 #define YUREI_AUTH_TOKEN_MAX 512
+#define YUREI_MAX_ENDPOINTS 8
+#define YUREI_MAX_FILTER_ACCOUNTS 8
+#define YUREI_PUBKEY_B58_MAX 48
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+typedef enum {
+    YUREI_DECODER_SCANNER = 0,   // hand-written wire scanner, generated fallback
+    YUREI_DECODER_GENERATED,     // protobuf-c generated unpack only
+    YUREI_DECODER_CROSSCHECK     // run both, compare, emit from generated
+} yurei_decoder_mode_t;
+
+typedef enum {
+    YUREI_INGEST_TRANSACTIONS = 0,  // one update per matching transaction
+    YUREI_INGEST_BLOCKS             // one update per block with its matching transactions
+} yurei_ingest_mode_t;
+
+// Values match geyser.CommitmentLevel.
+typedef enum {
+    YUREI_COMMITMENT_PROCESSED = 0,
+    YUREI_COMMITMENT_CONFIRMED = 1,
+    YUREI_COMMITMENT_FINALIZED = 2
+} yurei_commitment_t;
+
+// How a transaction filter treats vote or failed transactions; maps onto
+// the optional vote/failed flags of SubscribeRequestFilterTransactions.
+typedef enum {
+    YUREI_TX_FLAG_EXCLUDE = 0,   // flag = false
+    YUREI_TX_FLAG_INCLUDE,       // flag unset
+    YUREI_TX_FLAG_ONLY           // flag = true
+} yurei_tx_flag_t;
+
+// Server-side narrowing of one protocol's transaction filter.  Accounts are
+// kept base58 as they go on the wire.
+typedef struct {
+    yurei_tx_flag_t vote;
+    yurei_tx_flag_t failed;
+    char account_exclude[YUREI_MAX_FILTER_ACCOUNTS][YUREI_PUBKEY_B58_MAX];
+    size_t n_account_exclude;
+    char account_required[YUREI_MAX_FILTER_ACCOUNTS][YUREI_PUBKEY_B58_MAX];
+    size_t n_account_required;
+} yurei_tx_filter_config_t;
+
+// Message encodings the client advertises in grpc-accept-encoding
+#define YUREI_ENCODING_GZIP    (1u << 0)
+#define YUREI_ENCODING_DEFLATE (1u << 1)
+
+typedef struct {
+    char endpoint[YUREI_ENDPOINT_MAX];
+    char authority[YUREI_AUTHORITY_MAX];
+} yurei_endpoint_t;
+
 typedef struct {
     char endpoint[YUREI_ENDPOINT_MAX];
     char authority[YUREI_AUTHORITY_MAX];
     char db_url[YUREI_DB_URL_MAX];
     char auth_token[YUREI_AUTH_TOKEN_MAX];
+    // Endpoints raced against each other; entry 0 mirrors endpoint/authority
+    // unless YUREI_GEYSER_ENDPOINTS lists several.
+    yurei_endpoint_t endpoints[YUREI_MAX_ENDPOINTS];
+    size_t n_endpoints;
+    bool shard_by_program;
+    size_t dedup_capacity;
+    uint64_t dedup_slot_window;
     uint8_t pumpfun_program[32];
     uint8_t raydium_program[32];
     bool pumpfun_enabled;
     bool raydium_enabled;
+    // More programs for the detector registry, each routed to a protocol
+    yurei_protocol_program_t extra_programs[YUREI_DETECTOR_MAX_PROGRAMS];
+    size_t n_extra_programs;
+    yurei_tx_filter_config_t pumpfun_filter;
+    yurei_tx_filter_config_t raydium_filter;
     uint64_t from_slot;
     bool from_slot_set;
     size_t queue_capacity;
+    size_t decode_workers;
+    size_t pipeline_depth;
+    yurei_decoder_mode_t decoder_mode;
+    yurei_ingest_mode_t ingest_mode;
+    uint32_t ping_interval_ms;
+    // Stall watchdog: head-slot probe interval (0 disables) and how many
+    // slots a stream may trail the head without progress
+    uint32_t watchdog_interval_ms;
+    uint64_t stall_slots;
+    uint32_t reconnect_base_ms;
+    uint32_t reconnect_max_ms;
+    yurei_commitment_t commitment;
+    // Per-program overrides, applied to program shards
+    yurei_commitment_t pumpfun_commitment;
+    yurei_commitment_t raydium_commitment;
+    bool slot_tracking;
+    bool account_streams;
+    char control_socket[108];
+    char checkpoint_name[64];
+    uint64_t checkpoint_rewind;
+    uint32_t checkpoint_interval_ms;
+    // gRPC channel arguments; 0 keeps the gRPC default
+    int grpc_max_recv_bytes;
+    bool grpc_bdp_probe;
+    int grpc_stream_window_bytes;
+    int grpc_max_frame_bytes;
+    int grpc_keepalive_ms;
+    int grpc_keepalive_timeout_ms;
+    uint32_t grpc_accept_encodings;
+    // Raw stream capture; empty dir disables it
+    char capture_dir[256];
+    size_t capture_segment_bytes;
+    size_t capture_buffer_bytes;
+    // Historical backfill of [start, end) next to the live streams; disabled
+    // unless end > start
+    uint64_t backfill_start_slot;
+    uint64_t backfill_end_slot;
+    size_t backfill_streams;
+    size_t backfill_queue_capacity;
+    // Slot gap detection (0 disables) and automatic repair of the gaps
+    uint64_t slot_gap_grace_slots;
+    bool slot_gap_repair;
+    // Thread topology: stream (receive) threads and decode workers are each
+    // pinned to one CPU of their list in turn, the writer and the threads
+    // gRPC starts may use any CPU of theirs; empty lists leave threads alone
+    yurei_cpu_list_t ingest_cpus;
+    yurei_cpu_list_t decode_cpus;
+    yurei_cpu_list_t writer_cpus;
+    yurei_cpu_list_t grpc_cpus;
+    // GRPC_POLL_STRATEGY for the process unless already set (empty keeps
+    // gRPC's choice), and spinning on the live completion queues
+    char grpc_poll_strategy[32];
+    bool busy_poll;
 } yurei_config_t;
 
 bool yurei_config_load(yurei_config_t *config);
 
+bool yurei_commitment_parse(const char *name, yurei_commitment_t *out);
+const char *yurei_commitment_name(yurei_commitment_t commitment);
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,9 +19,24 @@ extern "C" {
 typedef enum {
     YUREI_EVENT_NONE = 0,
     YUREI_EVENT_PUMPFUN_TRADE,
-    YUREI_EVENT_RAYDIUM_SWAP
+    YUREI_EVENT_RAYDIUM_SWAP,
+    YUREI_EVENT_SLOT_STATUS,
+    YUREI_EVENT_PUMPFUN_CURVE,
+    YUREI_EVENT_RAYDIUM_POOL,
+    YUREI_EVENT_BLOCK_END,
+    // A live stream is past a slot (slot_update.slot); moves its source's
+    // checkpoint watermark when no rows do
+    YUREI_EVENT_SLOT_PROGRESS
 } yurei_event_type_t;
 
+// geyser.SlotStatus values the writer acts on
+typedef enum {
+    YUREI_SLOT_PROCESSED = 0,
+    YUREI_SLOT_CONFIRMED = 1,
+    YUREI_SLOT_FINALIZED = 2,
+    YUREI_SLOT_DEAD = 6
+} yurei_slot_status_t;
+
 typedef struct {
     uint8_t mint[32];
     uint8_t trader[32];
@@ -49,12 +64,77 @@ typedef struct {
     uint64_t slot;
 } yurei_raydium_swap_t;
 
+// PumpFun BondingCurve account state
+typedef struct {
+    uint8_t bonding_curve[32];
+    uint8_t creator[32];
+    bool has_creator;
+    uint64_t virtual_token_reserves;
+    uint64_t virtual_sol_reserves;
+    uint64_t real_token_reserves;
+    uint64_t real_sol_reserves;
+    uint64_t token_total_supply;
+    bool complete;
+    uint64_t slot;
+    uint64_t write_version;
+} yurei_pumpfun_curve_t;
+
+// Raydium AMM v4 AmmInfo fields needed to price a pool from its vaults
+typedef struct {
+    uint8_t amm[32];
+    uint8_t coin_vault[32];
+    uint8_t pc_vault[32];
+    uint8_t coin_mint[32];
+    uint8_t pc_mint[32];
+    uint8_t lp_mint[32];
+    uint64_t status;
+    uint64_t coin_decimals;
+    uint64_t pc_decimals;
+    uint64_t need_take_pnl_coin;
+    uint64_t need_take_pnl_pc;
+    uint64_t lp_amount;
+    uint64_t slot;
+    uint64_t write_version;
+} yurei_raydium_pool_t;
+
+typedef struct {
+    uint64_t slot;
+    uint64_t parent;
+    yurei_slot_status_t status;
+} yurei_slot_update_t;
+
+// Follows the events of one block update (block ingest mode)
+typedef struct {
+    uint64_t slot;
+    uint32_t events;
+} yurei_block_end_t;
+
 typedef struct {
     yurei_event_type_t type;
+    // Commitment level the event was observed at (yurei_commitment_t)
+    uint8_t commitment;
+    // Replayed by a backfill stream: never advances the checkpoint
+    bool backfill;
+    // Checkpoint source (shard) of the live stream that produced it
+    uint8_t source;
+    // Transaction events: position in the block (-1 when unknown) and block
+    // time in unix seconds (0 unless ingesting whole blocks)
+    int32_t tx_index;
+    int64_t block_time;
+    // Latency accounting: provider send time (SubscribeUpdate.created_at in
+    // unix ns, 0 when not sent) and local monotonic stage timestamps
+    int64_t created_at_ns;
+    uint64_t recv_ns;
+    uint64_t enqueue_ns;
+    uint64_t dequeue_ns;
     char signature[YUREI_MAX_SIGNATURE_LEN];
     union {
         yurei_pumpfun_trade_t pumpfun_trade;
         yurei_raydium_swap_t raydium_swap;
+        yurei_slot_update_t slot_update;
+        yurei_pumpfun_curve_t pumpfun_curve;
+        yurei_raydium_pool_t raydium_pool;
+        yurei_block_end_t block_end;
     } data;
 } yurei_event_t;
 
@@ -15,7 +15,10 @@ CREATE TABLE IF NOT EXISTS pumpfun_trades (
     virtual_sol_reserves NUMERIC NOT NULL,
     virtual_token_reserves NUMERIC NOT NULL,
     real_sol_reserves NUMERIC NOT NULL,
-    real_token_reserves NUMERIC NOT NULL
+    real_token_reserves NUMERIC NOT NULL,
+    commitment TEXT NOT NULL DEFAULT 'processed',
+    tx_index INTEGER,
+    block_time TIMESTAMPTZ
 );
 
 CREATE TABLE IF NOT EXISTS raydium_swaps (
@@ -25,5 +28,57 @@ CREATE TABLE IF NOT EXISTS raydium_swaps (
     pool TEXT NOT NULL,
     user_owner TEXT NOT NULL,
     amount_in NUMERIC NOT NULL,
-    amount_out NUMERIC NOT NULL
+    amount_out NUMERIC NOT NULL,
+    commitment TEXT NOT NULL DEFAULT 'processed',
+    tx_index INTEGER,
+    block_time TIMESTAMPTZ
+);
+
+-- One row per transaction; replays after a resume are ignored by the writer
+CREATE UNIQUE INDEX IF NOT EXISTS pumpfun_trades_slot_signature ON pumpfun_trades (slot, tx_signature);
+CREATE UNIQUE INDEX IF NOT EXISTS raydium_swaps_slot_signature ON raydium_swaps (slot, tx_signature);
+
+-- Account state history, one row per account write
+CREATE TABLE IF NOT EXISTS pumpfun_bonding_curves (
+    observed_at TIMESTAMPTZ DEFAULT now(),
+    slot BIGINT NOT NULL,
+    write_version BIGINT NOT NULL,
+    bonding_curve TEXT NOT NULL,
+    creator TEXT,
+    virtual_sol_reserves NUMERIC NOT NULL,
+    virtual_token_reserves NUMERIC NOT NULL,
+    real_sol_reserves NUMERIC NOT NULL,
+    real_token_reserves NUMERIC NOT NULL,
+    token_total_supply NUMERIC NOT NULL,
+    complete BOOLEAN NOT NULL,
+    commitment TEXT NOT NULL DEFAULT 'processed'
+);
+
+CREATE TABLE IF NOT EXISTS raydium_pools (
+    observed_at TIMESTAMPTZ DEFAULT now(),
+    slot BIGINT NOT NULL,
+    write_version BIGINT NOT NULL,
+    pool TEXT NOT NULL,
+    status NUMERIC NOT NULL,
+    coin_mint TEXT NOT NULL,
+    pc_mint TEXT NOT NULL,
+    lp_mint TEXT NOT NULL,
+    coin_vault TEXT NOT NULL,
+    pc_vault TEXT NOT NULL,
+    coin_decimals SMALLINT NOT NULL,
+    pc_decimals SMALLINT NOT NULL,
+    need_take_pnl_coin NUMERIC NOT NULL,
+    need_take_pnl_pc NUMERIC NOT NULL,
+    lp_amount NUMERIC NOT NULL,
+    commitment TEXT NOT NULL DEFAULT 'processed'
+);
+
+CREATE UNIQUE INDEX IF NOT EXISTS pumpfun_bonding_curves_write ON pumpfun_bonding_curves (slot, bonding_curve, write_version);
+CREATE UNIQUE INDEX IF NOT EXISTS raydium_pools_write ON raydium_pools (slot, pool, write_version);
+
+-- Highest slot whose events are fully committed, per checkpoint name
+CREATE TABLE IF NOT EXISTS yurei_checkpoints (
+    name TEXT PRIMARY KEY,
+    slot BIGINT NOT NULL,
+    updated_at TIMESTAMPTZ NOT NULL DEFAULT now()
 );
@@ -34,7 +34,10 @@ CREATE TABLE IF NOT EXISTS pumpfun_trades (
     virtual_sol_reserves NUMERIC NOT NULL,
     virtual_token_reserves NUMERIC NOT NULL,
     real_sol_reserves NUMERIC NOT NULL,
-    real_token_reserves NUMERIC NOT NULL
+    real_token_reserves NUMERIC NOT NULL,
+    commitment TEXT NOT NULL DEFAULT 'processed',
+    tx_index INTEGER,
+    block_time TIMESTAMPTZ
 );
 
 CREATE TABLE IF NOT EXISTS raydium_swaps (
@@ -44,7 +47,10 @@ CREATE TABLE IF NOT EXISTS raydium_swaps (
     pool TEXT NOT NULL,
     user_owner TEXT NOT NULL,
     amount_in NUMERIC NOT NULL,
-    amount_out NUMERIC NOT NULL
+    amount_out NUMERIC NOT NULL,
+    commitment TEXT NOT NULL DEFAULT 'processed',
+    tx_index INTEGER,
+    block_time TIMESTAMPTZ
 );
 
 -- Ensure legacy deployments are migrated to NUMERIC quantities
@@ -63,6 +69,68 @@ ALTER TABLE IF EXISTS pumpfun_trades
 ALTER TABLE IF EXISTS raydium_swaps
     ALTER COLUMN amount_in TYPE NUMERIC USING amount_in::numeric,
     ALTER COLUMN amount_out TYPE NUMERIC USING amount_out::numeric;
+
+-- Commitment tracking ('processed', 'confirmed', 'finalized' or 'dead')
+ALTER TABLE IF EXISTS pumpfun_trades ADD COLUMN IF NOT EXISTS commitment TEXT NOT NULL DEFAULT 'processed';
+ALTER TABLE IF EXISTS raydium_swaps ADD COLUMN IF NOT EXISTS commitment TEXT NOT NULL DEFAULT 'processed';
+ALTER TABLE IF EXISTS pumpfun_trades ADD COLUMN IF NOT EXISTS tx_index INTEGER;
+ALTER TABLE IF EXISTS pumpfun_trades ADD COLUMN IF NOT EXISTS block_time TIMESTAMPTZ;
+ALTER TABLE IF EXISTS raydium_swaps ADD COLUMN IF NOT EXISTS tx_index INTEGER;
+ALTER TABLE IF EXISTS raydium_swaps ADD COLUMN IF NOT EXISTS block_time TIMESTAMPTZ;
+
+-- Drop duplicate rows left by earlier replays before adding the unique keys
+DELETE FROM pumpfun_trades a USING pumpfun_trades b
+    WHERE a.ctid < b.ctid AND a.slot = b.slot AND a.tx_signature = b.tx_signature;
+DELETE FROM raydium_swaps a USING raydium_swaps b
+    WHERE a.ctid < b.ctid AND a.slot = b.slot AND a.tx_signature = b.tx_signature;
+-- One row per transaction; replays after a resume are ignored by the writer
+CREATE UNIQUE INDEX IF NOT EXISTS pumpfun_trades_slot_signature ON pumpfun_trades (slot, tx_signature);
+CREATE UNIQUE INDEX IF NOT EXISTS raydium_swaps_slot_signature ON raydium_swaps (slot, tx_signature);
+
+-- Account state history, one row per account write
+CREATE TABLE IF NOT EXISTS pumpfun_bonding_curves (
+    observed_at TIMESTAMPTZ DEFAULT now(),
+    slot BIGINT NOT NULL,
+    write_version BIGINT NOT NULL,
+    bonding_curve TEXT NOT NULL,
+    creator TEXT,
+    virtual_sol_reserves NUMERIC NOT NULL,
+    virtual_token_reserves NUMERIC NOT NULL,
+    real_sol_reserves NUMERIC NOT NULL,
+    real_token_reserves NUMERIC NOT NULL,
+    token_total_supply NUMERIC NOT NULL,
+    complete BOOLEAN NOT NULL,
+    commitment TEXT NOT NULL DEFAULT 'processed'
+);
+
+CREATE TABLE IF NOT EXISTS raydium_pools (
+    observed_at TIMESTAMPTZ DEFAULT now(),
+    slot BIGINT NOT NULL,
+    write_version BIGINT NOT NULL,
+    pool TEXT NOT NULL,
+    status NUMERIC NOT NULL,
+    coin_mint TEXT NOT NULL,
+    pc_mint TEXT NOT NULL,
+    lp_mint TEXT NOT NULL,
+    coin_vault TEXT NOT NULL,
+    pc_vault TEXT NOT NULL,
+    coin_decimals SMALLINT NOT NULL,
+    pc_decimals SMALLINT NOT NULL,
+    need_take_pnl_coin NUMERIC NOT NULL,
+    need_take_pnl_pc NUMERIC NOT NULL,
+    lp_amount NUMERIC NOT NULL,
+    commitment TEXT NOT NULL DEFAULT 'processed'
+);
+
+CREATE UNIQUE INDEX IF NOT EXISTS pumpfun_bonding_curves_write ON pumpfun_bonding_curves (slot, bonding_curve, write_version);
+CREATE UNIQUE INDEX IF NOT EXISTS raydium_pools_write ON raydium_pools (slot, pool, write_version);
+
+-- Highest slot whose events are fully committed, per checkpoint name
+CREATE TABLE IF NOT EXISTS yurei_checkpoints (
+    name TEXT PRIMARY KEY,
+    slot BIGINT NOT NULL,
+    updated_at TIMESTAMPTZ NOT NULL DEFAULT now()
+);
 SQL
 
 echo "Schema ensured successfully."
@@ -0,0 +1,70 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#include "account_decoder.h"
+
+#include <string.h>
+
+const uint8_t account_decoder_pumpfun_curve_discriminator[8] = {23, 183, 248, 55, 96, 216, 172, 96};
+
+// BondingCurve after the discriminator: five u64 reserves/supply, the
+// complete flag, then the creator on curves created since it was added.
+const yurei_account_layout_t account_layout_pumpfun_curve = {
+    .slices = {{8, 73}},
+    .n_slices = 1,
+    .min_len = 41,
+};
+
+// AmmInfo: status, coin/pc decimals, need_take_pnl coin/pc, the two vaults
+// plus the coin, pc and lp mints, and lp_amount.
+const yurei_account_layout_t account_layout_raydium_pool = {
+    .slices = {{0, 8}, {32, 16}, {192, 16}, {336, 160}, {720, 8}},
+    .n_slices = 5,
+    .min_len = 208,
+};
+
+static uint64_t read_u64(const uint8_t *data) {
+    uint64_t v;
+    memcpy(&v, data, sizeof(v));
+    return v;
+}
+
+bool account_decode_pumpfun_curve(const uint8_t *pubkey, const uint8_t *data, size_t len,
+                                  yurei_pumpfun_curve_t *out) {
+    if (!pubkey || !data || !out || len < account_layout_pumpfun_curve.min_len)
+        return false;
+    memset(out, 0, sizeof(*out));
+    memcpy(out->bonding_curve, pubkey, 32);
+    out->virtual_token_reserves = read_u64(data);
+    out->virtual_sol_reserves = read_u64(data + 8);
+    out->real_token_reserves = read_u64(data + 16);
+    out->real_sol_reserves = read_u64(data + 24);
+    out->token_total_supply = read_u64(data + 32);
+    out->complete = data[40] != 0;
+    if (len >= 73) {
+        memcpy(out->creator, data + 41, 32);
+        out->has_creator = true;
+    }
+    return true;
+}
+
+bool account_decode_raydium_pool(const uint8_t *pubkey, const uint8_t *data, size_t len,
+                                 yurei_raydium_pool_t *out) {
+    if (!pubkey || !data || !out || len < account_layout_raydium_pool.min_len)
+        return false;
+    memset(out, 0, sizeof(*out));
+    memcpy(out->amm, pubkey, 32);
+    out->status = read_u64(data);
+    out->coin_decimals = read_u64(data + 8);
+    out->pc_decimals = read_u64(data + 16);
+    out->need_take_pnl_coin = read_u64(data + 24);
+    out->need_take_pnl_pc = read_u64(data + 32);
+    memcpy(out->coin_vault, data + 40, 32);
+    memcpy(out->pc_vault, data + 72, 32);
+    memcpy(out->coin_mint, data + 104, 32);
+    memcpy(out->pc_mint, data + 136, 32);
+    memcpy(out->lp_mint, data + 168, 32);
+    out->lp_amount = read_u64(data + 200);
+    return true;
+}
@@ -0,0 +1,53 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#include "checkpoint.h"
+
+#include "log.h"
+
+#include <libpq-fe.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+bool checkpoint_load(const char *db_url, const char *name, uint64_t *slot) {
+    if (!db_url || !name || !slot)
+        return false;
+    PGconn *conn = PQconnectdb(db_url);
+    if (PQstatus(conn) != CONNECTION_OK) {
+        LOG_WARN("checkpoint: cannot connect: %s", PQerrorMessage(conn));
+        PQfinish(conn);
+        return false;
+    }
+    const char *params[1] = {name};
+    PGresult *res = PQexecParams(conn, "SELECT slot FROM yurei_checkpoints WHERE name = $1",
+                                 1, NULL, params, NULL, NULL, 0);
+    bool found = false;
+    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+        LOG_WARN("checkpoint: load failed: %s", PQerrorMessage(conn));
+    } else if (PQntuples(res) == 1 && !PQgetisnull(res, 0, 0)) {
+        *slot = strtoull(PQgetvalue(res, 0, 0), NULL, 10);
+        found = *slot > 0;
+    }
+    PQclear(res);
+    PQfinish(conn);
+    return found;
+}
+
+bool checkpoint_store(struct pg_conn *conn, const char *name, uint64_t slot) {
+    if (!conn || !name)
+        return false;
+    char slot_text[24];
+    snprintf(slot_text, sizeof(slot_text), "%lu", (unsigned long)slot);
+    const char *params[2] = {name, slot_text};
+    PGresult *res = PQexecParams(conn,
+                                 "INSERT INTO yurei_checkpoints (name, slot, updated_at) VALUES ($1, $2, now()) "
+                                 "ON CONFLICT (name) DO UPDATE SET slot = GREATEST(yurei_checkpoints.slot, EXCLUDED.slot), "
+                                 "updated_at = EXCLUDED.updated_at",
+                                 2, NULL, params, NULL, NULL, 0);
+    bool ok = PQresultStatus(res) == PGRES_COMMAND_OK;
+    if (!ok)
+        LOG_WARN("checkpoint: store failed: %s", PQerrorMessage(conn));
+    PQclear(res);
+    return ok;
+}
@@ -0,0 +1,160 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#define _DEFAULT_SOURCE  // struct sockaddr_un, poll
+
+#include "control_socket.h"
+
+#include "log.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define CONTROL_POLL_MS 200
+#define CONTROL_LINE_MAX 512
+#define CONTROL_REPLY_MAX 512
+
+struct control_socket {
+    char path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+    int listen_fd;
+    control_handler_fn handler;
+    void *ctx;
+    pthread_t thread;
+    _Atomic bool running;
+};
+
+static bool write_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static void serve_client(struct control_socket *sock, int fd) {
+    char line[CONTROL_LINE_MAX];
+    size_t used = 0;
+    while (atomic_load(&sock->running)) {
+        struct pollfd pfd = {.fd = fd, .events = POLLIN};
+        int ready = poll(&pfd, 1, CONTROL_POLL_MS);
+        if (ready < 0 && errno != EINTR)
+            return;
+        if (ready <= 0)
+            continue;
+        ssize_t n = read(fd, line + used, sizeof(line) - 1 - used);
+        if (n <= 0)
+            return;
+        used += (size_t)n;
+        line[used] = '\0';
+
+        char *start = line;
+        char *newline;
+        while ((newline = strchr(start, '\n')) != NULL) {
+            *newline = '\0';
+            if (newline > start && newline[-1] == '\r')
+                newline[-1] = '\0';
+            char reply[CONTROL_REPLY_MAX];
+            reply[0] = '\0';
+            if (*start)
+                sock->handler(sock->ctx, start, reply, sizeof(reply) - 1);
+            size_t reply_len = strlen(reply);
+            reply[reply_len++] = '\n';
+            if (!write_all(fd, reply, reply_len))
+                return;
+            start = newline + 1;
+        }
+        used = (size_t)(line + used - start);
+        memmove(line, start, used);
+        if (used == sizeof(line) - 1) {
+            write_all(fd, "error line too long\n", 20);
+            return;
+        }
+    }
+}
+
+static void *control_thread(void *arg) {
+    struct control_socket *sock = arg;
+    while (atomic_load(&sock->running)) {
+        struct pollfd pfd = {.fd = sock->listen_fd, .events = POLLIN};
+        int ready = poll(&pfd, 1, CONTROL_POLL_MS);
+        if (ready <= 0)
+            continue;
+        int fd = accept(sock->listen_fd, NULL, NULL);
+        if (fd < 0)
+            continue;
+        serve_client(sock, fd);
+        close(fd);
+    }
+    return NULL;
+}
+
+control_socket_t *control_socket_start(const char *path, control_handler_fn handler, void *ctx) {
+    if (!path || !*path || !handler)
+        return NULL;
+    struct control_socket *sock = calloc(1, sizeof(*sock));
+    if (!sock)
+        return NULL;
+    if (strlen(path) >= sizeof(sock->path)) {
+        LOG_ERROR("control socket path too long: %s", path);
+        free(sock);
+        return NULL;
+    }
+    snprintf(sock->path, sizeof(sock->path), "%s", path);
+    sock->handler = handler;
+    sock->ctx = ctx;
+
+    sock->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock->listen_fd < 0) {
+        LOG_ERROR("control socket: %s", strerror(errno));
+        free(sock);
+        return NULL;
+    }
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, sock->path, strlen(sock->path));
+    unlink(sock->path);
+    if (bind(sock->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(sock->listen_fd, 4) != 0) {
+        LOG_ERROR("control socket %s: %s", sock->path, strerror(errno));
+        close(sock->listen_fd);
+        free(sock);
+        return NULL;
+    }
+
+    atomic_store(&sock->running, true);
+    if (pthread_create(&sock->thread, NULL, control_thread, sock) != 0) {
+        LOG_ERROR("failed to start control socket thread");
+        close(sock->listen_fd);
+        unlink(sock->path);
+        free(sock);
+        return NULL;
+    }
+    LOG_INFO("control socket listening on %s", sock->path);
+    return sock;
+}
+
+void control_socket_stop(control_socket_t *sock) {
+    if (!sock)
+        return;
+    atomic_store(&sock->running, false);
+    pthread_join(sock->thread, NULL);
+    close(sock->listen_fd);
+    unlink(sock->path);
+    free(sock);
+}
@@ -9,9 +9,11 @@
 #include "base58.h"
 #include "log.h"
 #include "metrics.h"
+#include "topology.h"
 
 #include <libpq-fe.h>
 #include <pthread.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -21,6 +23,8 @@
 // Batch configuration
 #define BATCH_SIZE 100          // Max events per batch
 #define FLUSH_INTERVAL_MS 50    // Max delay before flush (milliseconds)
+#define SLOT_STATUS_RING 4096   // Recent slot statuses, indexed by slot
+#define LOST_SLOTS_MAX 32       // Rolled-back slots awaiting re-delivery
 
 struct db_writer {
     yurei_event_queue_t *queue;
@@ -34,9 +38,96 @@ struct db_writer {
     size_t pumpfun_count;
     yurei_event_t raydium_batch[BATCH_SIZE];
     size_t raydium_count;
+    yurei_event_t curve_batch[BATCH_SIZE];
+    size_t curve_count;
+    yurei_event_t pool_batch[BATCH_SIZE];
+    size_t pool_count;
     struct timeval last_flush;
+
+    // Block ingest: the rows of one block go into one transaction, opened
+    // at its first event and committed at its BLOCK_END marker.
+    bool in_block;
+    // A flush inside the open block failed: it was rolled back on the spot
+    // and its remaining rows are dropped until the BLOCK_END marker.
+    bool block_failed;
+    // Slot of the open (or failed) block
+    uint64_t block_slot;
+    // Slots whose rows were rolled back, lowest first.  The checkpoint stays
+    // below the lowest until a reconnect or restart re-delivers that slot
+    // and its block commits.  Past LOST_SLOTS_MAX the hold is kept until
+    // restart, since a forgotten slot could otherwise be skipped.
+    uint64_t lost_slots[LOST_SLOTS_MAX];
+    size_t n_lost_slots;
+    bool lost_overflow;
+
+    // Slot checkpointing: highest slot popped so far per source, and what
+    // was last persisted to yurei_checkpoints.
+    yurei_checkpoint_t *checkpoint;
+    uint64_t popped_max_slot[YUREI_CHECKPOINT_SOURCES];
+    uint64_t stored_slot;
+    uint64_t last_checkpoint_ms;
+
+    // Statuses of recent slots, so rows that arrive after their slot was
+    // confirmed (or died) are inserted with the right commitment.
+    struct {
+        uint64_t slot;
+        yurei_slot_status_t status;
+    } slot_status[SLOT_STATUS_RING];
 };
 
+static const char *slot_status_name(yurei_slot_status_t status) {
+    switch (status) {
+    case YUREI_SLOT_CONFIRMED:
+        return "confirmed";
+    case YUREI_SLOT_FINALIZED:
+        return "finalized";
+    case YUREI_SLOT_DEAD:
+        return "dead";
+    case YUREI_SLOT_PROCESSED:
+    default:
+        return "processed";
+    }
+}
+
+// Commitment column value for a new row: the known slot status wins over
+// the level the event was observed at.
+static const char *row_commitment(const struct db_writer *writer, const yurei_event_t *event, uint64_t slot) {
+    size_t idx = slot % SLOT_STATUS_RING;
+    if (slot != 0 && writer->slot_status[idx].slot == slot)
+        return slot_status_name(writer->slot_status[idx].status);
+    return slot_status_name((yurei_slot_status_t)event->commitment);
+}
+
+// tx_index / block_time column values; NULL when the stream did not say.
+static void format_position(const yurei_event_t *event, char *tx_index, size_t tx_index_len,
+                            char *block_time, size_t block_time_len) {
+    if (event->tx_index >= 0)
+        snprintf(tx_index, tx_index_len, "%d", event->tx_index);
+    else
+        snprintf(tx_index, tx_index_len, "NULL");
+    if (event->block_time > 0)
+        snprintf(block_time, block_time_len, "to_timestamp(%ld)", (long)event->block_time);
+    else
+        snprintf(block_time, block_time_len, "NULL");
+}
+
+// Stage latencies of a batch that just committed.  In block mode this is
+// the insert inside the block's transaction, which commits with the block.
+static void record_commit_latency(const yurei_event_t *events, size_t count) {
+    uint64_t now_ns = metrics_now_ns();
+    int64_t wall_ns = metrics_wall_ns();
+    for (size_t i = 0; i < count; ++i) {
+        const yurei_event_t *event = &events[i];
+        if (event->backfill)
+            continue;
+        uint64_t dequeue_us = now_ns > event->dequeue_ns ? (now_ns - event->dequeue_ns) / 1000 : 0;
+        uint64_t recv_us = event->recv_ns && now_ns > event->recv_ns ? (now_ns - event->recv_ns) / 1000 : 0;
+        int64_t provider_ns = wall_ns - event->created_at_ns;
+        metrics_record_commit_latency(dequeue_us, recv_us, event->created_at_ns != 0,
+                                      provider_ns > 0 ? (uint64_t)provider_ns / 1000 : 0);
+    }
+}
+
 static bool ensure_connection(struct db_writer *writer) {
     if (!writer->conn) {
         writer->conn = PQconnectdb(writer->config->db_url);
@@ -54,6 +145,56 @@ static bool ensure_connection(struct db_writer *writer) {
     return true;
 }
 
+// Multi-row INSERT text.  Appends grow the buffer when a row does not fit
+// the initial estimate, so the length never passes the allocation; a failed
+// allocation is remembered and the statement is not sent.
+typedef struct {
+    char *data;
+    size_t size;
+    size_t len;
+    bool failed;
+} query_buf_t;
+
+static bool query_init(query_buf_t *query, size_t size) {
+    query->data = malloc(size);
+    query->size = size;
+    query->len = 0;
+    query->failed = query->data == NULL;
+    if (query->data)
+        query->data[0] = '\0';
+    return !query->failed;
+}
+
+__attribute__((format(printf, 2, 3)))
+static void query_append(query_buf_t *query, const char *fmt, ...) {
+    if (query->failed)
+        return;
+    while (true) {
+        va_list args;
+        va_start(args, fmt);
+        int written = vsnprintf(query->data + query->len, query->size - query->len, fmt, args);
+        va_end(args);
+        if (written < 0) {
+            query->failed = true;
+            return;
+        }
+        if ((size_t)written < query->size - query->len) {
+            query->len += (size_t)written;
+            return;
+        }
+        size_t size = query->size * 2;
+        while (size - query->len <= (size_t)written)
+            size *= 2;
+        char *grown = realloc(query->data, size);
+        if (!grown) {
+            query->failed = true;
+            return;
+        }
+        query->data = grown;
+        query->size = size;
+    }
+}
+
 static uint64_t get_time_ms(void) {
     struct timeval tv;
     gettimeofday(&tv, NULL);
@@ -69,15 +210,15 @@ static bool flush_pumpfun_batch(struct db_writer *writer) {
     
     // Build multi-row INSERT statement
     // Estimated max size: header + (count * row_size)
-    size_t buf_size = 512 + writer->pumpfun_count * 600;
-    char *query = malloc(buf_size);
-    if (!query) return false;
+    query_buf_t query;
+    if (!query_init(&query, 512 + writer->pumpfun_count * 600)) return false;
     
-    strcpy(query, "INSERT INTO pumpfun_trades (slot, tx_signature, mint, trader, creator, side, "
-                  "sol_amount, token_amount, fee_bps, fee_lamports, creator_fee_bps, creator_fee_lamports, "
-                  "virtual_sol_reserves, virtual_token_reserves, real_sol_reserves, real_token_reserves) VALUES ");
+    query_append(&query, "INSERT INTO pumpfun_trades (slot, tx_signature, mint, trader, creator, side, "
+                         "sol_amount, token_amount, fee_bps, fee_lamports, creator_fee_bps, creator_fee_lamports, "
+                         "virtual_sol_reserves, virtual_token_reserves, real_sol_reserves, real_token_reserves, commitment, "
+                         "tx_index, block_time) VALUES ");
     
-    size_t offset = strlen(query);
+    size_t rows = 0;
     
     for (size_t i = 0; i < writer->pumpfun_count; i++) {
         const yurei_event_t *event = &writer->pumpfun_batch[i];
@@ -89,12 +230,15 @@ static bool flush_pumpfun_batch(struct db_writer *writer) {
             continue;
         }
         
-        if (i > 0) {
-            offset += snprintf(query + offset, buf_size - offset, ",");
+        char tx_index[16], block_time[40];
+        format_position(event, tx_index, sizeof(tx_index), block_time, sizeof(block_time));
+
+        if (rows++ > 0) {
+            query_append(&query, ",");
         }
         
-        offset += snprintf(query + offset, buf_size - offset,
-            "(%lu,'%s','%s','%s','%s','%s',%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu)",
+        query_append(&query,
+            "(%lu,'%s','%s','%s','%s','%s',%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,'%s',%s,%s)",
             event->data.pumpfun_trade.slot,
             event->signature,
             mint_b58, trader_b58, creator_b58,
@@ -108,11 +252,19 @@ static bool flush_pumpfun_batch(struct db_writer *writer) {
             event->data.pumpfun_trade.virtual_sol_reserves,
             event->data.pumpfun_trade.virtual_token_reserves,
             event->data.pumpfun_trade.real_sol_reserves,
-            event->data.pumpfun_trade.real_token_reserves);
+            event->data.pumpfun_trade.real_token_reserves,
+            row_commitment(writer, event, event->data.pumpfun_trade.slot),
+            tx_index, block_time);
     }
+    // Rows replayed after a resume are already stored
+    query_append(&query, " ON CONFLICT (slot, tx_signature) DO NOTHING");
     
-    PGresult *res = PQexec(writer->conn, query);
-    free(query);
+    if (query.failed) {
+        free(query.data);
+        return false;
+    }
+    PGresult *res = PQexec(writer->conn, query.data);
+    free(query.data);
     
     uint64_t latency = get_time_ms() - start_time;
     metrics_add_db_latency(latency * 1000);  // Convert to microseconds
@@ -130,6 +282,7 @@ static bool flush_pumpfun_batch(struct db_writer *writer) {
         metrics_inc_db_success();
         metrics_inc_pumpfun();
     }
+    record_commit_latency(writer->pumpfun_batch, writer->pumpfun_count);
     metrics_inc_db_batch();
     
     LOG_DEBUG("Flushed %zu PumpFun events in %lu ms", writer->pumpfun_count, latency);
@@ -144,13 +297,15 @@ static bool flush_raydium_batch(struct db_writer *writer) {
 
     uint64_t start_time = get_time_ms();
     
-    size_t buf_size = 256 + writer->raydium_count * 300;
-    char *query = malloc(buf_size);
-    if (!query) return false;
+    query_buf_t query;
+    // Worst case is about 320 bytes a row: an 88-char signature, two
+    // pubkeys, three 20-digit numbers and a to_timestamp() block time
+    if (!query_init(&query, 256 + writer->raydium_count * 400)) return false;
     
-    strcpy(query, "INSERT INTO raydium_swaps (slot, tx_signature, pool, user_owner, amount_in, amount_out) VALUES ");
+    query_append(&query, "INSERT INTO raydium_swaps (slot, tx_signature, pool, user_owner, amount_in, amount_out, commitment, "
+                         "tx_index, block_time) VALUES ");
     
-    size_t offset = strlen(query);
+    size_t rows = 0;
     
     for (size_t i = 0; i < writer->raydium_count; i++) {
         const yurei_event_t *event = &writer->raydium_batch[i];
@@ -161,21 +316,31 @@ static bool flush_raydium_batch(struct db_writer *writer) {
             continue;
         }
         
-        if (i > 0) {
-            offset += snprintf(query + offset, buf_size - offset, ",");
+        char tx_index[16], block_time[40];
+        format_position(event, tx_index, sizeof(tx_index), block_time, sizeof(block_time));
+
+        if (rows++ > 0) {
+            query_append(&query, ",");
         }
         
-        offset += snprintf(query + offset, buf_size - offset,
-            "(%lu,'%s','%s','%s',%lu,%lu)",
+        query_append(&query,
+            "(%lu,'%s','%s','%s',%lu,%lu,'%s',%s,%s)",
             event->data.raydium_swap.slot,
             event->signature,
             amm_b58, owner_b58,
             event->data.raydium_swap.amount_in,
-            event->data.raydium_swap.amount_out);
+            event->data.raydium_swap.amount_out,
+            row_commitment(writer, event, event->data.raydium_swap.slot),
+            tx_index, block_time);
     }
+    query_append(&query, " ON CONFLICT (slot, tx_signature) DO NOTHING");
     
-    PGresult *res = PQexec(writer->conn, query);
-    free(query);
+    if (query.failed) {
+        free(query.data);
+        return false;
+    }
+    PGresult *res = PQexec(writer->conn, query.data);
+    free(query.data);
     
     uint64_t latency = get_time_ms() - start_time;
     metrics_add_db_latency(latency * 1000);
@@ -193,6 +358,7 @@ static bool flush_raydium_batch(struct db_writer *writer) {
         metrics_inc_db_success();
         metrics_inc_raydium();
     }
+    record_commit_latency(writer->raydium_batch, writer->raydium_count);
     metrics_inc_db_batch();
     
     LOG_DEBUG("Flushed %zu Raydium events in %lu ms", writer->raydium_count, latency);
@@ -200,12 +366,454 @@ static bool flush_raydium_batch(struct db_writer *writer) {
     return true;
 }
 
+// Flush PumpFun bonding-curve states using multi-row INSERT
+static bool flush_curve_batch(struct db_writer *writer) {
+    if (writer->curve_count == 0) return true;
+    if (!ensure_connection(writer)) return false;
+
+    uint64_t start_time = get_time_ms();
+
+    query_buf_t query;
+    if (!query_init(&query, 512 + writer->curve_count * 400)) return false;
+
+    query_append(&query, "INSERT INTO pumpfun_bonding_curves (slot, write_version, bonding_curve, creator, "
+                         "virtual_sol_reserves, virtual_token_reserves, real_sol_reserves, real_token_reserves, "
+                         "token_total_supply, complete, commitment) VALUES ");
+
+    size_t rows = 0;
+
+    for (size_t i = 0; i < writer->curve_count; i++) {
+        const yurei_event_t *event = &writer->curve_batch[i];
+        const yurei_pumpfun_curve_t *curve = &event->data.pumpfun_curve;
+
+        char curve_b58[64], creator_sql[70] = "NULL";
+        if (base58_encode(curve->bonding_curve, 32, curve_b58, sizeof(curve_b58)) < 0)
+            continue;
+        if (curve->has_creator) {
+            char creator_b58[64];
+            if (base58_encode(curve->creator, 32, creator_b58, sizeof(creator_b58)) < 0)
+                continue;
+            snprintf(creator_sql, sizeof(creator_sql), "'%s'", creator_b58);
+        }
+
+        if (rows++ > 0) {
+            query_append(&query, ",");
+        }
+
+        query_append(&query,
+            "(%lu,%lu,'%s',%s,%lu,%lu,%lu,%lu,%lu,%s,'%s')",
+            curve->slot,
+            curve->write_version,
+            curve_b58, creator_sql,
+            curve->virtual_sol_reserves,
+            curve->virtual_token_reserves,
+            curve->real_sol_reserves,
+            curve->real_token_reserves,
+            curve->token_total_supply,
+            curve->complete ? "true" : "false",
+            row_commitment(writer, event, curve->slot));
+    }
+    if (rows == 0) {
+        free(query.data);
+        writer->curve_count = 0;
+        return true;
+    }
+    query_append(&query, " ON CONFLICT (slot, bonding_curve, write_version) DO NOTHING");
+
+    if (query.failed) {
+        free(query.data);
+        return false;
+    }
+    PGresult *res = PQexec(writer->conn, query.data);
+    free(query.data);
+
+    uint64_t latency = get_time_ms() - start_time;
+    metrics_add_db_latency(latency * 1000);
+
+    if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+        LOG_ERROR("bonding curve batch insert failed: %s", PQerrorMessage(writer->conn));
+        PQclear(res);
+        metrics_inc_db_failed();
+        return false;
+    }
+
+    PQclear(res);
+
+    for (size_t i = 0; i < writer->curve_count; i++) {
+        metrics_inc_db_success();
+        metrics_inc_pumpfun_curve();
+    }
+    record_commit_latency(writer->curve_batch, writer->curve_count);
+    metrics_inc_db_batch();
+
+    LOG_DEBUG("Flushed %zu bonding curve states in %lu ms", writer->curve_count, latency);
+    writer->curve_count = 0;
+    return true;
+}
+
+// Flush Raydium pool states using multi-row INSERT
+static bool flush_pool_batch(struct db_writer *writer) {
+    if (writer->pool_count == 0) return true;
+    if (!ensure_connection(writer)) return false;
+
+    uint64_t start_time = get_time_ms();
+
+    query_buf_t query;
+    if (!query_init(&query, 512 + writer->pool_count * 600)) return false;
+
+    query_append(&query, "INSERT INTO raydium_pools (slot, write_version, pool, status, coin_mint, pc_mint, lp_mint, "
+                         "coin_vault, pc_vault, coin_decimals, pc_decimals, need_take_pnl_coin, need_take_pnl_pc, "
+                         "lp_amount, commitment) VALUES ");
+
+    size_t rows = 0;
+
+    for (size_t i = 0; i < writer->pool_count; i++) {
+        const yurei_event_t *event = &writer->pool_batch[i];
+        const yurei_raydium_pool_t *pool = &event->data.raydium_pool;
+
+        char pool_b58[64], coin_mint_b58[64], pc_mint_b58[64], lp_mint_b58[64], coin_vault_b58[64], pc_vault_b58[64];
+        if (base58_encode(pool->amm, 32, pool_b58, sizeof(pool_b58)) < 0 ||
+            base58_encode(pool->coin_mint, 32, coin_mint_b58, sizeof(coin_mint_b58)) < 0 ||
+            base58_encode(pool->pc_mint, 32, pc_mint_b58, sizeof(pc_mint_b58)) < 0 ||
+            base58_encode(pool->lp_mint, 32, lp_mint_b58, sizeof(lp_mint_b58)) < 0 ||
+            base58_encode(pool->coin_vault, 32, coin_vault_b58, sizeof(coin_vault_b58)) < 0 ||
+            base58_encode(pool->pc_vault, 32, pc_vault_b58, sizeof(pc_vault_b58)) < 0) {
+            continue;
+        }
+
+        if (rows++ > 0) {
+            query_append(&query, ",");
+        }
+
+        query_append(&query,
+            "(%lu,%lu,'%s',%lu,'%s','%s','%s','%s','%s',%lu,%lu,%lu,%lu,%lu,'%s')",
+            pool->slot,
+            pool->write_version,
+            pool_b58,
+            pool->status,
+            coin_mint_b58, pc_mint_b58, lp_mint_b58,
+            coin_vault_b58, pc_vault_b58,
+            pool->coin_decimals,
+            pool->pc_decimals,
+            pool->need_take_pnl_coin,
+            pool->need_take_pnl_pc,
+            pool->lp_amount,
+            row_commitment(writer, event, pool->slot));
+    }
+    if (rows == 0) {
+        free(query.data);
+        writer->pool_count = 0;
+        return true;
+    }
+    query_append(&query, " ON CONFLICT (slot, pool, write_version) DO NOTHING");
+
+    if (query.failed) {
+        free(query.data);
+        return false;
+    }
+    PGresult *res = PQexec(writer->conn, query.data);
+    free(query.data);
+
+    uint64_t latency = get_time_ms() - start_time;
+    metrics_add_db_latency(latency * 1000);
+
+    if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+        LOG_ERROR("raydium pool batch insert failed: %s", PQerrorMessage(writer->conn));
+        PQclear(res);
+        metrics_inc_db_failed();
+        return false;
+    }
+
+    PQclear(res);
+
+    for (size_t i = 0; i < writer->pool_count; i++) {
+        metrics_inc_db_success();
+        metrics_inc_raydium_pool();
+    }
+    record_commit_latency(writer->pool_batch, writer->pool_count);
+    metrics_inc_db_batch();
+
+    LOG_DEBUG("Flushed %zu Raydium pool states in %lu ms", writer->pool_count, latency);
+    writer->pool_count = 0;
+    return true;
+}
+
+static uint64_t event_slot(const yurei_event_t *event) {
+    switch (event->type) {
+    case YUREI_EVENT_PUMPFUN_TRADE:
+        return event->data.pumpfun_trade.slot;
+    case YUREI_EVENT_RAYDIUM_SWAP:
+        return event->data.raydium_swap.slot;
+    case YUREI_EVENT_PUMPFUN_CURVE:
+        return event->data.pumpfun_curve.slot;
+    case YUREI_EVENT_RAYDIUM_POOL:
+        return event->data.raydium_pool.slot;
+    default:
+        return 0;
+    }
+}
+
+// Holds the checkpoint below `slot`, whose rows did not reach Postgres.
+static void hold_checkpoint(struct db_writer *writer, uint64_t slot) {
+    if (slot == 0)
+        return;
+    size_t i = 0;
+    while (i < writer->n_lost_slots && writer->lost_slots[i] < slot)
+        ++i;
+    if (i < writer->n_lost_slots && writer->lost_slots[i] == slot)
+        return;
+    if (writer->n_lost_slots == LOST_SLOTS_MAX) {
+        if (!writer->lost_overflow)
+            LOG_ERROR("more than %d slots rolled back; checkpoint held below slot %lu until restart",
+                      LOST_SLOTS_MAX, (unsigned long)writer->lost_slots[0]);
+        writer->lost_overflow = true;
+        if (i == LOST_SLOTS_MAX)
+            return;
+        writer->n_lost_slots--;
+    }
+    memmove(&writer->lost_slots[i + 1], &writer->lost_slots[i],
+            (writer->n_lost_slots - i) * sizeof(writer->lost_slots[0]));
+    writer->lost_slots[i] = slot;
+    writer->n_lost_slots++;
+    if (i == 0)
+        LOG_WARN("checkpoint held below slot %lu until it is re-delivered", (unsigned long)slot);
+    metrics_set_checkpoint_held_slot(writer->lost_slots[0]);
+}
+
+// A lost slot was re-delivered and its block committed.
+static void release_checkpoint(struct db_writer *writer, uint64_t slot) {
+    if (writer->lost_overflow)
+        return;
+    size_t i = 0;
+    while (i < writer->n_lost_slots && writer->lost_slots[i] != slot)
+        ++i;
+    if (i == writer->n_lost_slots)
+        return;
+    writer->n_lost_slots--;
+    memmove(&writer->lost_slots[i], &writer->lost_slots[i + 1],
+            (writer->n_lost_slots - i) * sizeof(writer->lost_slots[0]));
+    if (i == 0)
+        LOG_INFO("slot %lu re-delivered and committed, checkpoint released", (unsigned long)slot);
+    metrics_set_checkpoint_held_slot(writer->n_lost_slots ? writer->lost_slots[0] : 0);
+}
+
+// Once nothing popped is left unflushed, every event of a source up to the
+// highest slot seen from it is in Postgres and that slot becomes the
+// source's watermark.  The lowest watermark is the shared checkpoint, so a
+// restart never skips a source that trails the others.  Persisting is
+// throttled; the in-memory values are what reconnecting streams use.
+static void commit_checkpoint(struct db_writer *writer, bool force) {
+    if (!writer->checkpoint || writer->in_block || writer->block_failed)
+        return;
+    if (writer->pumpfun_count != 0 || writer->raydium_count != 0 ||
+        writer->curve_count != 0 || writer->pool_count != 0)
+        return;
+    uint64_t held = writer->n_lost_slots ? writer->lost_slots[0] : 0;
+    uint64_t lowest = 0;
+    for (size_t source = 0; source < YUREI_CHECKPOINT_SOURCES; ++source) {
+        uint64_t reached = writer->popped_max_slot[source];
+        if (held && reached >= held)
+            reached = held - 1;
+        if (reached == 0)
+            continue;
+        checkpoint_advance_source(writer->checkpoint, source, reached);
+        if (lowest == 0 || reached < lowest)
+            lowest = reached;
+    }
+    if (lowest == 0)
+        return;
+    checkpoint_advance(writer->checkpoint, lowest);
+    uint64_t slot = checkpoint_slot(writer->checkpoint);
+    metrics_set_checkpoint_slot(slot);
+    if (slot == writer->stored_slot)
+        return;
+    uint64_t now = get_time_ms();
+    if (!force && now - writer->last_checkpoint_ms < writer->config->checkpoint_interval_ms)
+        return;
+    if (!ensure_connection(writer))
+        return;
+    if (checkpoint_store(writer->conn, writer->config->checkpoint_name, slot)) {
+        writer->stored_slot = slot;
+        writer->last_checkpoint_ms = now;
+    }
+}
+
 static void flush_all_batches(struct db_writer *writer) {
     flush_pumpfun_batch(writer);
     flush_raydium_batch(writer);
+    flush_curve_batch(writer);
+    flush_pool_batch(writer);
+    commit_checkpoint(writer, false);
     gettimeofday(&writer->last_flush, NULL);
 }
 
+// Promotes (or flags dead) every row of a slot with one UPDATE per table,
+// sent as a single round trip.  Pending rows are flushed first so they are
+// covered; rows that arrive later pick the status up from the ring.  The
+// WHERE clauses only move forward: processed -> confirmed -> finalized,
+// and finalized rows are never marked dead.
+static void apply_slot_status(struct db_writer *writer, const yurei_slot_update_t *update) {
+    size_t idx = update->slot % SLOT_STATUS_RING;
+    writer->slot_status[idx].slot = update->slot;
+    writer->slot_status[idx].status = update->status;
+
+    const char *from;
+    switch (update->status) {
+    case YUREI_SLOT_CONFIRMED:
+        from = "('processed')";
+        metrics_inc_slot_confirmed();
+        break;
+    case YUREI_SLOT_FINALIZED:
+        from = "('processed','confirmed')";
+        metrics_inc_slot_finalized();
+        break;
+    case YUREI_SLOT_DEAD:
+        from = "('processed','confirmed')";
+        metrics_inc_slot_dead();
+        LOG_WARN("slot %lu died; flagging its rows", (unsigned long)update->slot);
+        break;
+    default:
+        return;
+    }
+
+    flush_all_batches(writer);
+    if (!ensure_connection(writer))
+        return;
+    const char *to = slot_status_name(update->status);
+    static const char *const tables[] = {"pumpfun_trades", "raydium_swaps", "pumpfun_bonding_curves", "raydium_pools"};
+    char query[1024];
+    size_t offset = 0;
+    for (size_t i = 0; i < sizeof(tables) / sizeof(tables[0]); ++i) {
+        offset += snprintf(query + offset, sizeof(query) - offset,
+                           "%sUPDATE %s SET commitment = '%s' WHERE slot = %lu AND commitment IN %s",
+                           i > 0 ? ";" : "", tables[i], to, (unsigned long)update->slot, from);
+    }
+    uint64_t start_time = get_time_ms();
+    PGresult *res = PQexec(writer->conn, query);
+    metrics_add_db_latency((get_time_ms() - start_time) * 1000);
+    if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+        LOG_ERROR("slot %lu status update failed: %s", (unsigned long)update->slot, PQerrorMessage(writer->conn));
+        metrics_inc_db_failed();
+    }
+    PQclear(res);
+}
+
+static void reset_batches(struct db_writer *writer) {
+    writer->pumpfun_count = 0;
+    writer->raydium_count = 0;
+    writer->curve_count = 0;
+    writer->pool_count = 0;
+}
+
+// After a failed statement Postgres rejects everything else in the
+// transaction, so the block is rolled back as soon as a flush inside it
+// fails and the rest of its rows are dropped.
+static void fail_block(struct db_writer *writer) {
+    if (writer->conn) {
+        PGresult *res = PQexec(writer->conn, "ROLLBACK");
+        PQclear(res);
+    }
+    writer->in_block = false;
+    writer->block_failed = true;
+    reset_batches(writer);
+}
+
+// Flushes what is left of the block and commits it.  If any part failed the
+// whole block is rolled back and its remaining rows dropped, so a slot is
+// either fully stored or not at all.
+static void end_block(struct db_writer *writer, const yurei_block_end_t *end) {
+    if (!writer->in_block && !writer->block_failed)
+        return;
+    if (writer->in_block && end->slot != writer->block_slot) {
+        LOG_WARN("end of block %lu while block %lu is open", (unsigned long)end->slot,
+                 (unsigned long)writer->block_slot);
+        fail_block(writer);
+    }
+    bool ok = writer->in_block;
+    if (writer->in_block) {
+        ok = flush_pumpfun_batch(writer);
+        ok = flush_raydium_batch(writer) && ok;
+        ok = flush_curve_batch(writer) && ok;
+        ok = flush_pool_batch(writer) && ok;
+        uint64_t start_time = get_time_ms();
+        PGresult *res = writer->conn ? PQexec(writer->conn, ok ? "COMMIT" : "ROLLBACK") : NULL;
+        if (ok && PQresultStatus(res) != PGRES_COMMAND_OK)
+            ok = false;
+        PQclear(res);
+        metrics_add_db_latency((get_time_ms() - start_time) * 1000);
+        writer->in_block = false;
+    }
+    writer->block_failed = false;
+    if (ok) {
+        release_checkpoint(writer, writer->block_slot);
+    } else {
+        LOG_ERROR("block %lu rolled back (%u events)", (unsigned long)writer->block_slot, end->events);
+        metrics_inc_db_failed();
+        hold_checkpoint(writer, writer->block_slot);
+        if (end->slot != writer->block_slot)
+            hold_checkpoint(writer, end->slot);
+        reset_batches(writer);
+    }
+    commit_checkpoint(writer, false);
+    gettimeofday(&writer->last_flush, NULL);
+}
+
+// The open block will not see its end marker (cut off by the shutdown, or
+// another slot's rows arrived first): roll it back like a failed one.
+static void abandon_block(struct db_writer *writer) {
+    if (writer->in_block)
+        fail_block(writer);
+    yurei_block_end_t end = {writer->block_slot, 0};
+    end_block(writer, &end);
+}
+
+// Opens the block's transaction at its first row.  One transaction only
+// ever holds rows of one slot.
+static void begin_block(struct db_writer *writer, uint64_t slot) {
+    if ((writer->in_block || writer->block_failed) && slot != writer->block_slot) {
+        LOG_WARN("rows of slot %lu arrived inside block %lu", (unsigned long)slot, (unsigned long)writer->block_slot);
+        abandon_block(writer);
+    }
+    if (writer->in_block || writer->block_failed || !ensure_connection(writer))
+        return;
+    PGresult *res = PQexec(writer->conn, "BEGIN");
+    writer->in_block = PQresultStatus(res) == PGRES_COMMAND_OK;
+    writer->block_slot = slot;
+    if (!writer->in_block)
+        LOG_WARN("BEGIN failed, writing block rows without a transaction: %s", PQerrorMessage(writer->conn));
+    PQclear(res);
+}
+
+// Adds a row to one batch and flushes the batch once it is full.  A failed
+// flush inside a block fails the block.  Outside one the rows are kept and
+// a row that finds its batch still full waits for the flush to go through,
+// retried with backoff, so the writer stops taking rows instead of
+// dropping them; the queue applies backpressure meanwhile.  Only a
+// shutdown drops the row, and its slot then holds the checkpoint.
+static void append_row(struct db_writer *writer, yurei_event_t *batch, size_t *count,
+                       bool (*flush)(struct db_writer *), const yurei_event_t *event) {
+    if (*count == BATCH_SIZE && !flush(writer)) {
+        if (writer->in_block) {
+            fail_block(writer);
+            return;
+        }
+        useconds_t backoff_us = 10000;
+        while (!flush(writer)) {
+            if (!writer->running) {
+                hold_checkpoint(writer, event_slot(event));
+                metrics_inc_db_failed();
+                return;
+            }
+            usleep(backoff_us);
+            if (backoff_us < 1000000)
+                backoff_us *= 2;
+        }
+    }
+    batch[(*count)++] = *event;
+    if (*count == BATCH_SIZE && !flush(writer) && writer->in_block)
+        fail_block(writer);
+}
+
 static bool should_flush_timer(struct db_writer *writer) {
     struct timeval now;
     gettimeofday(&now, NULL);
@@ -214,6 +822,15 @@ static bool should_flush_timer(struct db_writer *writer) {
     return elapsed_ms >= FLUSH_INTERVAL_MS;
 }
 
+// Live events move their source's watermark: rows by their slot, progress
+// markers by the slot their stream got past.
+static void note_popped(struct db_writer *writer, const yurei_event_t *event, uint64_t slot) {
+    if (event->backfill || event->source >= YUREI_CHECKPOINT_SOURCES)
+        return;
+    if (slot > writer->popped_max_slot[event->source])
+        writer->popped_max_slot[event->source] = slot;
+}
+
 static void *db_writer_main(void *arg) {
     struct db_writer *writer = arg;
     gettimeofday(&writer->last_flush, NULL);
@@ -223,41 +840,70 @@ static void *db_writer_main(void *arg) {
         
         // Non-blocking pop to allow timer-based flushing
         if (!event_queue_pop(writer->queue, &event, false)) {
-            // No event available - check flush timer
-            if (should_flush_timer(writer)) {
+            // No event available - check flush timer (an open block waits
+            // for its end marker)
+            if (!writer->in_block && should_flush_timer(writer)) {
                 flush_all_batches(writer);
             }
             usleep(1000);  // 1ms sleep to avoid busy-wait
             continue;
         }
         
+        if (event.type == YUREI_EVENT_SLOT_STATUS) {
+            apply_slot_status(writer, &event.data.slot_update);
+            continue;
+        }
+        if (event.type == YUREI_EVENT_BLOCK_END) {
+            note_popped(writer, &event, event.data.block_end.slot);
+            end_block(writer, &event.data.block_end);
+            continue;
+        }
+        if (event.type == YUREI_EVENT_SLOT_PROGRESS) {
+            note_popped(writer, &event, event.data.slot_update.slot);
+            continue;
+        }
+        // Backfill rows never open a block transaction and never move the
+        // checkpoint, which tracks the live streams only.
+        bool block_row = writer->config->ingest_mode == YUREI_INGEST_BLOCKS && !event.backfill &&
+                         (event.type == YUREI_EVENT_PUMPFUN_TRADE || event.type == YUREI_EVENT_RAYDIUM_SWAP);
+
         metrics_inc_events_total();
+        uint64_t slot = event_slot(&event);
+        note_popped(writer, &event, slot);
+        if (block_row)
+            begin_block(writer, slot);
+        if (block_row && writer->block_failed)
+            continue;
         
         switch (event.type) {
         case YUREI_EVENT_PUMPFUN_TRADE:
-            writer->pumpfun_batch[writer->pumpfun_count++] = event;
-            if (writer->pumpfun_count >= BATCH_SIZE) {
-                flush_pumpfun_batch(writer);
-            }
+            append_row(writer, writer->pumpfun_batch, &writer->pumpfun_count, flush_pumpfun_batch, &event);
             break;
         case YUREI_EVENT_RAYDIUM_SWAP:
-            writer->raydium_batch[writer->raydium_count++] = event;
-            if (writer->raydium_count >= BATCH_SIZE) {
-                flush_raydium_batch(writer);
-            }
+            append_row(writer, writer->raydium_batch, &writer->raydium_count, flush_raydium_batch, &event);
+            break;
+        case YUREI_EVENT_PUMPFUN_CURVE:
+            append_row(writer, writer->curve_batch, &writer->curve_count, flush_curve_batch, &event);
+            break;
+        case YUREI_EVENT_RAYDIUM_POOL:
+            append_row(writer, writer->pool_batch, &writer->pool_count, flush_pool_batch, &event);
             break;
         default:
             break;
         }
         
         // Timer-based flush for low-volume periods
-        if (should_flush_timer(writer)) {
+        if (!writer->in_block && should_flush_timer(writer)) {
             flush_all_batches(writer);
         }
     }
     
-    // Final flush on shutdown
+    // Final flush on shutdown; a block cut short by the shutdown is rolled
+    // back, never committed half-received
+    if (writer->in_block || writer->block_failed)
+        abandon_block(writer);
     flush_all_batches(writer);
+    commit_checkpoint(writer, true);
     
     if (writer->conn) {
         PQfinish(writer->conn);
@@ -274,6 +920,9 @@ db_writer_t *db_writer_start(const db_writer_params_t *params) {
         return NULL;
     writer->queue = params->queue;
     writer->config = params->config;
+    writer->checkpoint = params->checkpoint;
+    if (writer->checkpoint)
+        writer->stored_slot = checkpoint_slot(writer->checkpoint);
     writer->running = true;
     writer->pumpfun_count = 0;
     writer->raydium_count = 0;
@@ -282,6 +931,7 @@ db_writer_t *db_writer_start(const db_writer_params_t *params) {
         free(writer);
         return NULL;
     }
+    topology_bind_thread(writer->thread, &writer->config->writer_cpus);
     
     LOG_INFO("DB writer started (batch_size=%d, flush_interval=%dms)", BATCH_SIZE, FLUSH_INTERVAL_MS);
     return writer;
@@ -0,0 +1,133 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#include "dedup_set.h"
+
+#include "metrics.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEDUP_SHARDS 64
+#define DEDUP_MAX_PROBE 16
+
+// Signatures are ed25519 outputs, so their leading bytes are already
+// uniformly distributed and double as the hash.  16 bytes plus the slot
+// make accidental collisions negligible.
+typedef struct {
+    uint64_t key[2];
+    uint64_t slot_plus_one;  // 0 marks a never-used entry
+    uint64_t first_ns;
+    uint32_t source;
+} dedup_entry_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    dedup_entry_t *entries;
+} dedup_shard_t;
+
+struct yurei_dedup_set {
+    dedup_shard_t shards[DEDUP_SHARDS];
+    size_t shard_mask;
+    uint64_t slot_window;
+    _Atomic uint64_t max_slot;
+};
+
+static size_t round_up_pow2(size_t v) {
+    size_t p = 1;
+    while (p < v)
+        p <<= 1;
+    return p;
+}
+
+yurei_dedup_set_t *dedup_set_create(size_t capacity, uint64_t slot_window) {
+    struct yurei_dedup_set *set = calloc(1, sizeof(*set));
+    if (!set)
+        return NULL;
+    size_t per_shard = round_up_pow2(capacity / DEDUP_SHARDS > DEDUP_MAX_PROBE ? capacity / DEDUP_SHARDS : DEDUP_MAX_PROBE);
+    for (size_t i = 0; i < DEDUP_SHARDS; ++i) {
+        set->shards[i].entries = calloc(per_shard, sizeof(dedup_entry_t));
+        if (!set->shards[i].entries) {
+            dedup_set_destroy(set);
+            return NULL;
+        }
+        pthread_mutex_init(&set->shards[i].lock, NULL);
+    }
+    set->shard_mask = per_shard - 1;
+    set->slot_window = slot_window;
+    return set;
+}
+
+void dedup_set_destroy(yurei_dedup_set_t *set) {
+    if (!set)
+        return;
+    for (size_t i = 0; i < DEDUP_SHARDS; ++i) {
+        if (!set->shards[i].entries)
+            continue;
+        pthread_mutex_destroy(&set->shards[i].lock);
+        free(set->shards[i].entries);
+    }
+    free(set);
+}
+
+bool dedup_set_insert(yurei_dedup_set_t *set,
+                      const uint8_t *signature,
+                      size_t signature_len,
+                      uint64_t slot,
+                      uint32_t source,
+                      uint64_t now_ns,
+                      uint32_t *first_source,
+                      uint64_t *first_ns) {
+    uint64_t key[2] = {0, 0};
+    memcpy(key, signature, signature_len < sizeof(key) ? signature_len : sizeof(key));
+
+    uint64_t max_slot = atomic_load_explicit(&set->max_slot, memory_order_relaxed);
+    while (slot > max_slot &&
+           !atomic_compare_exchange_weak_explicit(&set->max_slot, &max_slot, slot,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+    if (slot > max_slot)
+        max_slot = slot;
+
+    dedup_shard_t *shard = &set->shards[key[0] % DEDUP_SHARDS];
+    size_t home = (size_t)(key[1] & set->shard_mask);
+    dedup_entry_t *victim = NULL;
+
+    // Entries are never cleared, only overwritten, so a stored pair always
+    // sits before the first never-used entry of its probe window.  The
+    // replacement candidate is the entry with the oldest slot: unused entries
+    // first, then ones that fell out of the slot window, then the oldest live
+    // one, so an insert is never refused.
+    pthread_mutex_lock(&shard->lock);
+    for (size_t probe = 0; probe < DEDUP_MAX_PROBE; ++probe) {
+        dedup_entry_t *entry = &shard->entries[(home + probe) & set->shard_mask];
+        if (entry->slot_plus_one == slot + 1 && entry->key[0] == key[0] && entry->key[1] == key[1]) {
+            if (first_source)
+                *first_source = entry->source;
+            if (first_ns)
+                *first_ns = entry->first_ns;
+            if (now_ns < entry->first_ns) {
+                entry->first_ns = now_ns;
+                entry->source = source;
+            }
+            pthread_mutex_unlock(&shard->lock);
+            return false;
+        }
+        if (!victim || entry->slot_plus_one < victim->slot_plus_one)
+            victim = entry;
+        if (entry->slot_plus_one == 0)
+            break;
+    }
+    if (victim->slot_plus_one != 0 && victim->slot_plus_one - 1 + set->slot_window >= max_slot)
+        metrics_inc_dedup_eviction();
+    victim->key[0] = key[0];
+    victim->key[1] = key[1];
+    victim->slot_plus_one = slot + 1;
+    victim->first_ns = now_ns;
+    victim->source = source;
+    pthread_mutex_unlock(&shard->lock);
+    return true;
+}
@@ -9,6 +9,17 @@
 #include <stdlib.h>
 #include <string.h>
 
+// Backfill events wait in a second ring that is only popped while the live
+// one is empty, so a backlog of history never delays live events.
+typedef struct {
+    yurei_event_t *buffer;
+    size_t capacity;
+    size_t head;
+    size_t tail;
+    size_t size;
+    pthread_cond_t not_full;
+} backfill_lane_t;
+
 struct yurei_event_queue {
     yurei_event_t *buffer;
     size_t capacity;
@@ -18,6 +29,10 @@ struct yurei_event_queue {
     pthread_mutex_t lock;
     pthread_cond_t not_empty;
     pthread_cond_t not_full;
+    backfill_lane_t backfill;
+    // A batch larger than the ring is being written in pieces; other
+    // producers wait so nothing lands in the middle of it.
+    bool batch_open;
     bool closed;
 };
 
@@ -43,20 +58,46 @@ void event_queue_destroy(yurei_event_queue_t *queue) {
     pthread_mutex_destroy(&queue->lock);
     pthread_cond_destroy(&queue->not_empty);
     pthread_cond_destroy(&queue->not_full);
+    if (queue->backfill.buffer) {
+        pthread_cond_destroy(&queue->backfill.not_full);
+        free(queue->backfill.buffer);
+    }
     free(queue->buffer);
     free(queue);
 }
 
+bool event_queue_enable_backfill(yurei_event_queue_t *queue, size_t capacity) {
+    if (capacity == 0)
+        return false;
+    pthread_mutex_lock(&queue->lock);
+    bool ok = queue->backfill.buffer != NULL;
+    if (!ok) {
+        queue->backfill.buffer = calloc(capacity, sizeof(yurei_event_t));
+        ok = queue->backfill.buffer != NULL;
+        if (ok) {
+            queue->backfill.capacity = capacity;
+            pthread_cond_init(&queue->backfill.not_full, NULL);
+        }
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return ok;
+}
+
 bool event_queue_push(yurei_event_queue_t *queue, const yurei_event_t *event) {
     pthread_mutex_lock(&queue->lock);
-    while (!queue->closed && queue->size == queue->capacity) {
+    while (!queue->closed && (queue->batch_open || queue->size == queue->capacity)) {
         pthread_cond_wait(&queue->not_full, &queue->lock);
     }
     if (queue->closed) {
         pthread_mutex_unlock(&queue->lock);
         return false;
     }
-    queue->buffer[queue->tail] = *event;
+    uint64_t now = metrics_now_ns();
+    yurei_event_t *slot = &queue->buffer[queue->tail];
+    *slot = *event;
+    slot->enqueue_ns = now;
+    if (slot->recv_ns)
+        metrics_record_enqueue_latency(now > slot->recv_ns ? (now - slot->recv_ns) / 1000 : 0);
     queue->tail = (queue->tail + 1) % queue->capacity;
     queue->size++;
     
@@ -69,15 +110,99 @@ bool event_queue_push(yurei_event_queue_t *queue, const yurei_event_t *event) {
     return true;
 }
 
+// The batch goes in as one contiguous run, so the events of a block are
+// never interleaved with another producer's: it waits until the ring has
+// room for all of it.  A batch larger than the ring is written in pieces
+// while the other producers are held off.
+bool event_queue_push_batch(yurei_event_queue_t *queue, const yurei_event_t *events, size_t count) {
+    if (count == 0)
+        return true;
+    pthread_mutex_lock(&queue->lock);
+    size_t room = count < queue->capacity ? count : queue->capacity;
+    while (!queue->closed && (queue->batch_open || queue->capacity - queue->size < room)) {
+        pthread_cond_signal(&queue->not_empty);
+        pthread_cond_wait(&queue->not_full, &queue->lock);
+    }
+    queue->batch_open = count > room;
+    for (size_t i = 0; i < count; ++i) {
+        while (!queue->closed && queue->size == queue->capacity) {
+            pthread_cond_signal(&queue->not_empty);
+            pthread_cond_wait(&queue->not_full, &queue->lock);
+        }
+        if (queue->closed) {
+            queue->batch_open = false;
+            pthread_mutex_unlock(&queue->lock);
+            return false;
+        }
+        uint64_t now = metrics_now_ns();
+        yurei_event_t *slot = &queue->buffer[queue->tail];
+        *slot = events[i];
+        slot->enqueue_ns = now;
+        if (slot->recv_ns)
+            metrics_record_enqueue_latency(now > slot->recv_ns ? (now - slot->recv_ns) / 1000 : 0);
+        queue->tail = (queue->tail + 1) % queue->capacity;
+        queue->size++;
+        metrics_inc_queue_push();
+    }
+    metrics_update_queue_high_water(queue->size);
+    if (queue->batch_open) {
+        queue->batch_open = false;
+        pthread_cond_broadcast(&queue->not_full);
+    }
+
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+    return true;
+}
+
+// Events are not stamped: queue wait of history would only skew the live
+// latency histograms.
+bool event_queue_push_backfill(yurei_event_queue_t *queue, const yurei_event_t *events, size_t count) {
+    backfill_lane_t *lane = &queue->backfill;
+    if (count == 0)
+        return true;
+    if (!lane->buffer)
+        return false;
+    pthread_mutex_lock(&queue->lock);
+    for (size_t i = 0; i < count; ++i) {
+        while (!queue->closed && lane->size == lane->capacity) {
+            pthread_cond_signal(&queue->not_empty);
+            pthread_cond_wait(&lane->not_full, &queue->lock);
+        }
+        if (queue->closed) {
+            pthread_mutex_unlock(&queue->lock);
+            return false;
+        }
+        lane->buffer[lane->tail] = events[i];
+        lane->tail = (lane->tail + 1) % lane->capacity;
+        lane->size++;
+        metrics_inc_queue_push();
+    }
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+    return true;
+}
+
 bool event_queue_pop(yurei_event_queue_t *queue, yurei_event_t *event, bool block) {
     pthread_mutex_lock(&queue->lock);
-    while (!queue->closed && queue->size == 0) {
+    backfill_lane_t *lane = &queue->backfill;
+    while (!queue->closed && queue->size == 0 && lane->size == 0) {
         if (!block) {
             pthread_mutex_unlock(&queue->lock);
             return false;
         }
         pthread_cond_wait(&queue->not_empty, &queue->lock);
     }
+    if (queue->size == 0 && lane->size > 0) {
+        *event = lane->buffer[lane->head];
+        lane->head = (lane->head + 1) % lane->capacity;
+        lane->size--;
+        metrics_inc_queue_pop();
+        event->dequeue_ns = metrics_now_ns();
+        pthread_cond_signal(&lane->not_full);
+        pthread_mutex_unlock(&queue->lock);
+        return true;
+    }
     if (queue->size == 0) {
         pthread_mutex_unlock(&queue->lock);
         return false;
@@ -88,8 +213,15 @@ bool event_queue_pop(yurei_event_queue_t *queue, yurei_event_t *event, bool bloc
     
     // Update metrics
     metrics_inc_queue_pop();
+    event->dequeue_ns = metrics_now_ns();
+    if (event->enqueue_ns)
+        metrics_record_queue_wait(event->dequeue_ns > event->enqueue_ns
+                                      ? (event->dequeue_ns - event->enqueue_ns) / 1000
+                                      : 0);
     
-    pthread_cond_signal(&queue->not_full);
+    // Producers wait for different amounts of room; waking one that still
+    // cannot fit would strand one that can.
+    pthread_cond_broadcast(&queue->not_full);
     pthread_mutex_unlock(&queue->lock);
     return true;
 }
@@ -99,6 +231,8 @@ void event_queue_close(yurei_event_queue_t *queue) {
     queue->closed = true;
     pthread_cond_broadcast(&queue->not_empty);
     pthread_cond_broadcast(&queue->not_full);
+    if (queue->backfill.buffer)
+        pthread_cond_broadcast(&queue->backfill.not_full);
     pthread_mutex_unlock(&queue->lock);
 }
 
@@ -113,3 +247,30 @@ size_t event_queue_capacity(yurei_event_queue_t *queue) {
     return queue->capacity;
 }
 
+void event_batch_init(yurei_event_batch_t *batch) {
+    batch->events = NULL;
+    batch->count = 0;
+    batch->capacity = 0;
+}
+
+bool event_batch_append(yurei_event_batch_t *batch, const yurei_event_t *event) {
+    if (batch->count == batch->capacity) {
+        size_t new_capacity = batch->capacity ? batch->capacity * 2 : 8;
+        yurei_event_t *grown = realloc(batch->events, new_capacity * sizeof(yurei_event_t));
+        if (!grown)
+            return false;
+        batch->events = grown;
+        batch->capacity = new_capacity;
+    }
+    batch->events[batch->count++] = *event;
+    return true;
+}
+
+void event_batch_reset(yurei_event_batch_t *batch) {
+    batch->count = 0;
+}
+
+void event_batch_free(yurei_event_batch_t *batch) {
+    free(batch->events);
+    event_batch_init(batch);
+}
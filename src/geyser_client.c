@@ -2,14 +2,25 @@
 // Copyright 2025 Project Yurei. All rights reserved.
 // https://x.com/yureiai
 
+#define _POSIX_C_SOURCE 200809L  // nanosleep, rand_r
+
 #include "geyser_client.h"
 
+#include "account_decoder.h"
 #include "base58.h"
 #include "base64.h"
+#include "dedup_set.h"
+#include "ingest_pipeline.h"
 #include "log.h"
+#include "metrics.h"
+#include "pb_arena.h"
 #include "protocol_detector.h"
 #include "pumpfun_parser.h"
 #include "raydium_parser.h"
+#include "slot_tracker.h"
+#include "stream_recorder.h"
+#include "topology.h"
+#include "update_scanner.h"
 
 #include <grpc/byte_buffer_reader.h>
 #include <grpc/grpc.h>
@@ -18,39 +29,174 @@
 #include <grpc/slice.h>
 
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "google/protobuf/timestamp.pb-c.h"
 #include "geyser.pb-c.h"
 #include "solana-storage.pb-c.h"
 
+#define GEYSER_MAX_STREAMS 32
+#define GEYSER_STREAM_NAME_MAX (YUREI_ENDPOINT_MAX + 32)
+#define GEYSER_CQ_POLL_MS 200
+// Deadline of the unary Geyser RPCs made next to the stream
+#define GEYSER_UNARY_TIMEOUT_MS 2000
+#define GEYSER_MAX_CHANNEL_ARGS 12
+// Failed attempts in a row before the channel is rebuilt from scratch
+#define GEYSER_CHANNEL_RESET_ATTEMPTS 5
+// Slots past its range a backfill stream keeps reading, so transactions of
+// the range that trail the first later slot are still written
+#define GEYSER_BACKFILL_TAIL_SLOTS 32
+// Slot gap detection: bitmap ring size, repair queue length, and how often
+// an idle repair stream looks for work
+#define GEYSER_SLOT_WINDOW 65536
+#define GEYSER_MAX_SLOT_GAPS 256
+#define GEYSER_REPAIR_POLL_MS 1000
+
+// Filter keys of the Subscribe request, also the slots of the per-filter
+// traffic metrics.
+enum {
+    GEYSER_FILTER_ALL = 0,
+    GEYSER_FILTER_PUMPFUN,
+    GEYSER_FILTER_RAYDIUM,
+    GEYSER_FILTER_SLOTS,
+    GEYSER_FILTER_PUMPFUN_CURVES,
+    GEYSER_FILTER_RAYDIUM_POOLS,
+    GEYSER_FILTER_BLOCKS,
+    GEYSER_FILTER_COUNT
+};
+
+static const char *const geyser_filter_keys[GEYSER_FILTER_COUNT] = {
+    "transactions", "pumpfun", "raydium", "slots", "pumpfun_curves", "raydium_pools", "blocks"};
+
+struct geyser_client;
+
+// Immutable snapshot of what the streams subscribe to.  Updates publish a new
+// snapshot; old ones stay allocated until the client stops because decode
+// threads may still be reading them, which keeps the hot path lock-free.
+typedef struct geyser_filters {
+    yurei_protocol_detector_t detector;
+    yurei_commitment_t commitment;
+    uint64_t generation;
+    struct geyser_filters *retired;
+} geyser_filters_t;
+
+// One Subscribe call kept alive against one endpoint, on its own thread and
+// completion queue.  `protocols` selects which watched programs go into the
+// stream's transaction filter (all of them unless sharding by program); an
+// account stream instead follows the state accounts of its one protocol.
+typedef struct {
+    struct geyser_client *client;
+    size_t index;
+    size_t endpoint_index;
+    yurei_endpoint_t endpoint;
+    uint32_t protocols;
+    bool account_updates;
+    // Checkpoint source: the shard index, the same on every endpoint, so a
+    // reconnect resumes from what this shard itself committed
+    uint8_t checkpoint_source;
+    char name[GEYSER_STREAM_NAME_MAX];
+    uint64_t from_slot;
+    bool from_slot_set;
+    bool replay_rejected;
+    yurei_event_batch_t inline_batch;
+    pthread_t thread;
+    bool started;
+    // Kept across calls so a reconnect reuses the HTTP/2 connection
+    grpc_channel_credentials *creds;
+    grpc_channel *channel;
+    grpc_completion_queue *cq;
+    unsigned failed_attempts;
+    uint64_t ended_ns;
+    unsigned rng_state;
+    // Keepalive state.  Pongs and server pings are seen by whichever thread
+    // decodes the update, so the receive thread shares these through atomics.
+    int32_t next_ping_id;
+    _Atomic int32_t ping_outstanding;
+    _Atomic uint64_t ping_sent_ns;
+    _Atomic bool ping_reply_due;
+    // Filter generation and commitment last sent on the live call
+    uint64_t filters_generation;
+    _Atomic int commitment;
+    bool track_slots;
+    // Stall watchdog: highest slot decoded on the current call, and whether
+    // the provider lacks GetSlot so probes fall back to Ping
+    _Atomic uint64_t latest_slot;
+    bool probe_with_ping;
+    // Lag behind the provider's head at the last probe
+    _Atomic uint64_t behind_head;
+    // Highest slot reported to the writer as checkpoint progress
+    _Atomic uint64_t progress_slot;
+    // Backfill streams replay [backfill_start, backfill_end) into the
+    // backfill lane of the queue and then finish.  backfill_slot is the
+    // highest slot replayed, kept across calls to resume from.  The repair
+    // stream is a backfill stream that takes its ranges from the slot
+    // tracker's gap queue, one after another.
+    bool backfill;
+    bool repair;
+    bool backfill_failed;
+    uint64_t backfill_start;
+    uint64_t backfill_end;
+    _Atomic uint64_t backfill_slot;
+    _Atomic bool backfill_done;
+} geyser_stream_t;
+
 struct geyser_client {
     yurei_config_t config;
-    yurei_protocol_detector_t detector;
+    _Atomic(geyser_filters_t *) filters;
+    pthread_mutex_t filters_lock;
     yurei_event_queue_t *queue;
-    pthread_t thread;
+    yurei_checkpoint_t *checkpoint;
+    yurei_ingest_pipeline_t *pipeline;
+    yurei_stream_recorder_t *recorder;
+    yurei_slot_tracker_t *slot_tracker;
+    yurei_dedup_set_t *dedup;
+    geyser_stream_t streams[GEYSER_MAX_STREAMS];
+    size_t n_streams;
     bool running;
 };
 
+// Waits at most `ms` for the next completion, so no loop on the queue can
+// block shutdown indefinitely.
+static grpc_event cq_next(grpc_completion_queue *cq, int ms) {
+    gpr_timespec wait = gpr_time_add(gpr_now(GPR_CLOCK_MONOTONIC), gpr_time_from_millis(ms, GPR_TIMESPAN));
+    return grpc_completion_queue_next(cq, wait, NULL);
+}
+
+// Busy polling: completions are requested with an already expired deadline,
+// so the thread polls the transport without ever sleeping; it still returns
+// after `ms` like cq_next.
+static grpc_event cq_spin(grpc_completion_queue *cq, int ms) {
+    uint64_t until_ns = metrics_now_ns() + (uint64_t)ms * 1000000ull;
+    while (true) {
+        grpc_event ev = grpc_completion_queue_next(cq, gpr_inf_past(GPR_CLOCK_MONOTONIC), NULL);
+        if (ev.type != GRPC_QUEUE_TIMEOUT || metrics_now_ns() >= until_ns)
+            return ev;
+    }
+}
+
+// Called once every call on the queue has finished, so the shutdown event
+// follows promptly; the bounded wait only turns a leak into a log line.
 static void destroy_completion_queue(grpc_completion_queue *cq) {
     if (!cq)
         return;
     grpc_completion_queue_shutdown(cq);
     while (true) {
-        grpc_event ev = grpc_completion_queue_next(cq, gpr_inf_future(GPR_CLOCK_REALTIME), NULL);
+        grpc_event ev = cq_next(cq, GEYSER_CQ_POLL_MS);
         if (ev.type == GRPC_QUEUE_SHUTDOWN)
             break;
+        if (ev.type == GRPC_QUEUE_TIMEOUT)
+            LOG_WARN("completion queue still draining");
     }
     grpc_completion_queue_destroy(cq);
 }
 
-#define CQ_CACHE_MAX_EVENTS 4
-
 static bool slice_contains_string(grpc_slice slice, const char *needle) {
     if (!needle || !*needle)
         return false;
@@ -66,226 +212,758 @@ static bool slice_contains_string(grpc_slice slice, const char *needle) {
     return false;
 }
 
-struct cq_event_cache_entry {
-    bool used;
-    grpc_event event;
+// One unary Geyser RPC: request, response and status buffers
+typedef struct {
+    grpc_call *call;
+    grpc_byte_buffer *payload;
+    grpc_byte_buffer *response;
+    grpc_metadata auth[1];
+    grpc_metadata_array recv_initial_metadata;
+    grpc_metadata_array trailing_metadata;
+    grpc_status_code status_code;
+    grpc_slice status_details;
+} geyser_unary_t;
+
+// State of one Subscribe call.  Every batch started on the call is a
+// geyser_call_op_t whose address is the completion-queue tag; the call loop
+// hands each completion to the op's callback, so completions are never
+// matched against an expected tag and none can be lost or reordered.
+typedef struct geyser_call_state geyser_call_state_t;
+typedef struct geyser_call_op geyser_call_op_t;
+
+struct geyser_call_op {
+    void (*on_complete)(geyser_call_state_t *state, bool success);
+    bool pending;
 };
 
-typedef struct {
-    struct cq_event_cache_entry entries[CQ_CACHE_MAX_EVENTS];
-} cq_event_cache_t;
+struct geyser_call_state {
+    geyser_stream_t *stream;
+    grpc_call *call;
+    grpc_completion_queue *cq;
+    // Initial metadata + first request, then the server's first metadata
+    geyser_call_op_t start_op;
+    geyser_call_op_t status_op;
+    geyser_call_op_t recv_op;
+    // Pings and filter updates; one send may be in flight on a call
+    geyser_call_op_t send_op;
+    // Watchdog head-slot probe, a unary call on the same queue
+    geyser_call_op_t probe_op;
+    geyser_unary_t probe;
+    uint64_t next_probe_ns;
+    // Head at the first probe, standing in for a call that saw no slot yet
+    uint64_t probe_base_head;
+    uint64_t probe_last_slot;
+    uint64_t progress_ns;
+    grpc_byte_buffer *start_payload;
+    grpc_byte_buffer *recv_buffer;
+    grpc_byte_buffer *send_buffer;
+    grpc_metadata_array recv_initial_metadata;
+    grpc_metadata_array trailing_metadata;
+    grpc_status_code status_code;
+    grpc_slice status_details;
+    bool busy_poll;
+    bool handshake_ok;
+    // The server ended the response stream; its status is on the way
+    bool recv_closed;
+    bool status_received;
+    bool call_ok;
+    bool received_any;
+};
 
-static bool cq_cache_take(cq_event_cache_t *cache, void *tag, grpc_event *out) {
-    if (!cache)
+static bool decode_program_data_line(const char *line, size_t line_len,
+                                     uint8_t *buffer, size_t buf_len, size_t *written) {
+    static const char prefix[] = "Program data: ";
+    const size_t prefix_len = sizeof(prefix) - 1;
+    if (!line || line_len <= prefix_len)
         return false;
-    for (size_t i = 0; i < CQ_CACHE_MAX_EVENTS; ++i) {
-        if (cache->entries[i].used && cache->entries[i].event.tag == tag) {
-            if (out)
-                *out = cache->entries[i].event;
-            cache->entries[i].used = false;
-            return true;
-        }
+    for (size_t i = 0; i + prefix_len < line_len; ++i) {
+        if (line[i] != 'P' || memcmp(line + i, prefix, prefix_len) != 0)
+            continue;
+        const char *pos = line + i + prefix_len;
+        return base64_decode(pos, line_len - i - prefix_len, buffer, buf_len, written) == 0;
     }
     return false;
 }
 
-static void cq_cache_store(cq_event_cache_t *cache, grpc_event ev) {
-    if (!cache)
-        return;
-    for (size_t i = 0; i < CQ_CACHE_MAX_EVENTS; ++i) {
-        if (!cache->entries[i].used) {
-            cache->entries[i].used = true;
-            cache->entries[i].event = ev;
-            return;
-        }
+static void dispatch_event(yurei_event_batch_t *out, const yurei_event_t *event) {
+    if (!event_batch_append(out, event)) {
+        LOG_WARN("dropping event because batch allocation failed");
     }
-    LOG_WARN("completion queue cache overflow, dropping tag %p", ev.tag);
 }
 
-static bool cq_wait_for_tag(grpc_completion_queue *cq,
-                            void *tag,
-                            cq_event_cache_t *cache,
-                            grpc_event *out) {
-    if (cq_cache_take(cache, tag, out))
-        return true;
-    while (true) {
-        grpc_event ev = grpc_completion_queue_next(cq, gpr_inf_future(GPR_CLOCK_REALTIME), NULL);
-        if (ev.type == GRPC_QUEUE_SHUTDOWN) {
-            if (out)
-                *out = ev;
-            return false;
+static void fill_signature(yurei_event_t *event, const yurei_tx_view_t *view) {
+    event->signature[0] = '\0';
+    if (view->signature && view->signature_len > 0) {
+        if (base58_encode(view->signature, view->signature_len, event->signature, sizeof(event->signature)) < 0) {
+            event->signature[0] = '\0';
         }
-        if (ev.type == GRPC_QUEUE_TIMEOUT)
-            continue;
-        if (ev.tag == tag) {
-            if (out)
-                *out = ev;
-            return true;
-        }
-        cq_cache_store(cache, ev);
-    }
-}
-
-static bool decode_program_data_line(const char *line, uint8_t *buffer, size_t buf_len, size_t *written) {
-    const char *prefix = "Program data: ";
-    const char *pos = strstr(line, prefix);
-    if (!pos)
-        return false;
-    pos += strlen(prefix);
-    size_t len = strlen(pos);
-    if (len == 0)
-        return false;
-    return base64_decode(pos, len, buffer, buf_len, written) == 0;
-}
-
-static void dispatch_event(struct geyser_client *client, yurei_event_t *event) {
-    if (!event_queue_push(client->queue, event)) {
-        LOG_WARN("dropping event because queue is unavailable");
     }
 }
 
-static void process_pumpfun(struct geyser_client *client,
-                            const Geyser__SubscribeUpdateTransaction *tx_update,
-                            const Solana__Storage__ConfirmedBlock__TransactionStatusMeta *meta) {
-    if (!meta || meta->log_messages == NULL)
-        return;
+static void process_pumpfun(yurei_event_batch_t *out, const yurei_tx_view_t *view) {
     uint8_t decode_buf[768];
-    for (size_t i = 0; i < meta->n_log_messages; ++i) {
+    for (size_t i = 0; i < view->n_log_messages; ++i) {
         size_t produced = 0;
-        if (!decode_program_data_line(meta->log_messages[i], decode_buf, sizeof(decode_buf), &produced))
+        if (!decode_program_data_line(view->log_messages[i], view->log_message_lens[i],
+                                      decode_buf, sizeof(decode_buf), &produced))
             continue;
         yurei_pumpfun_trade_t trade;
         if (!pumpfun_parse_trade(decode_buf, produced, &trade))
             continue;
         yurei_event_t event = {0};
         event.type = YUREI_EVENT_PUMPFUN_TRADE;
-        trade.slot = tx_update->has_slot ? tx_update->slot : 0;
+        trade.slot = view->has_slot ? view->slot : 0;
         event.data.pumpfun_trade = trade;
-        event.signature[0] = '\0';
-        if (tx_update->transaction && tx_update->transaction->signature.data && tx_update->transaction->signature.len > 0) {
-            if (base58_encode(tx_update->transaction->signature.data,
-                              tx_update->transaction->signature.len,
-                              event.signature,
-                              sizeof(event.signature)) < 0) {
-                event.signature[0] = '\0';
-            }
-        }
-        dispatch_event(client, &event);
+        fill_signature(&event, view);
+        dispatch_event(out, &event);
         return;
     }
 }
 
-static void process_raydium(struct geyser_client *client,
-                            const Geyser__SubscribeUpdateTransaction *tx_update,
-                            const Solana__Storage__ConfirmedBlock__TransactionStatusMeta *meta) {
-    if (!meta || meta->log_messages == NULL)
-        return;
+static void process_raydium(yurei_event_batch_t *out, const yurei_tx_view_t *view) {
     uint8_t decode_buf[512];
-    for (size_t i = 0; i < meta->n_log_messages; ++i) {
+    for (size_t i = 0; i < view->n_log_messages; ++i) {
         size_t produced = 0;
-        if (!decode_program_data_line(meta->log_messages[i], decode_buf, sizeof(decode_buf), &produced))
+        if (!decode_program_data_line(view->log_messages[i], view->log_message_lens[i],
+                                      decode_buf, sizeof(decode_buf), &produced))
             continue;
         yurei_raydium_swap_t swap;
         if (!raydium_parse_swap(decode_buf, produced, &swap))
             continue;
-        swap.slot = tx_update->has_slot ? tx_update->slot : 0;
+        swap.slot = view->has_slot ? view->slot : 0;
         yurei_event_t event = {0};
         event.type = YUREI_EVENT_RAYDIUM_SWAP;
         event.data.raydium_swap = swap;
-        event.signature[0] = '\0';
-        if (tx_update->transaction && tx_update->transaction->signature.data && tx_update->transaction->signature.len > 0) {
-            if (base58_encode(tx_update->transaction->signature.data,
-                              tx_update->transaction->signature.len,
-                              event.signature,
-                              sizeof(event.signature)) < 0) {
-                event.signature[0] = '\0';
-            }
-        }
-        dispatch_event(client, &event);
+        fill_signature(&event, view);
+        dispatch_event(out, &event);
         return;
     }
 }
 
-static void handle_transaction(struct geyser_client *client, Geyser__SubscribeUpdateTransaction *transaction) {
-    if (!transaction || !transaction->transaction)
-        return;
-    Solana__Storage__ConfirmedBlock__Transaction *sol_tx = transaction->transaction->transaction;
-    if (!sol_tx || !sol_tx->message)
-        return;
-    Solana__Storage__ConfirmedBlock__Message *msg = sol_tx->message;
-    if (!msg->account_keys)
+// With several streams racing, only the first arrival of a transaction is
+// parsed.  Arrival order is judged by receive time, not decode order, so a
+// copy that was received earlier but decoded later takes the win over.
+static bool first_arrival(geyser_stream_t *stream, const yurei_tx_view_t *view, uint64_t recv_ns) {
+    struct geyser_client *client = stream->client;
+    if (!client->dedup || stream->backfill || !view->signature || view->signature_len == 0)
+        return true;
+    uint32_t first_source = 0;
+    uint64_t first_ns = 0;
+    if (dedup_set_insert(client->dedup, view->signature, view->signature_len, view->slot,
+                         (uint32_t)stream->endpoint_index, recv_ns, &first_source, &first_ns)) {
+        metrics_inc_endpoint_won(stream->endpoint_index);
+        return true;
+    }
+    if (recv_ns < first_ns) {
+        metrics_transfer_endpoint_win(first_source, stream->endpoint_index);
+        metrics_record_endpoint_duplicate(first_source, (first_ns - recv_ns) / 1000);
+    } else {
+        metrics_record_endpoint_duplicate(stream->endpoint_index, (recv_ns - first_ns) / 1000);
+    }
+    return false;
+}
+
+static void handle_transaction(geyser_stream_t *stream,
+                               const yurei_tx_view_t *view,
+                               uint64_t recv_ns,
+                               yurei_event_batch_t *out) {
+    struct geyser_client *client = stream->client;
+    if (view->n_account_keys == 0)
         return;
-    size_t n_accounts = msg->n_account_keys;
-    if (n_accounts == 0)
+    if (!first_arrival(stream, view, recv_ns))
         return;
-    const uint8_t *account_ptrs[256];
-    size_t account_lens[256];
-    if (n_accounts > 256)
-        n_accounts = 256;
-    for (size_t i = 0; i < n_accounts; ++i) {
-        account_ptrs[i] = msg->account_keys[i].data;
-        account_lens[i] = msg->account_keys[i].len;
-    }
-    yurei_protocol_t proto = protocol_detector_match_accounts(&client->detector, account_ptrs, account_lens, n_accounts);
-    Solana__Storage__ConfirmedBlock__TransactionStatusMeta *meta = transaction->transaction->meta;
+    const geyser_filters_t *filters = atomic_load_explicit(&client->filters, memory_order_acquire);
+    yurei_protocol_t proto = protocol_detector_match_accounts(&filters->detector,
+                                                              view->account_keys,
+                                                              view->account_key_lens,
+                                                              view->n_account_keys);
+    size_t first = out->count;
     switch (proto) {
     case YUREI_PROTOCOL_PUMPFUN:
-        process_pumpfun(client, transaction, meta);
+        process_pumpfun(out, view);
         break;
     case YUREI_PROTOCOL_RAYDIUM:
-        process_raydium(client, transaction, meta);
+        process_raydium(out, view);
         break;
     default:
         break;
     }
+    uint8_t commitment = (uint8_t)atomic_load_explicit(&stream->commitment, memory_order_relaxed);
+    for (size_t i = first; i < out->count; ++i) {
+        out->events[i].commitment = commitment;
+        out->events[i].tx_index = view->has_tx_index ? (int32_t)view->tx_index : -1;
+        out->events[i].block_time = view->has_block_time ? view->block_time : 0;
+    }
 }
 
-static grpc_byte_buffer *build_subscribe_payload(const struct geyser_client *client) {
-    Geyser__SubscribeRequest request = GEYSER__SUBSCRIBE_REQUEST__INIT;
-    request.has_commitment = 1;
-    request.commitment = GEYSER__COMMITMENT_LEVEL__PROCESSED;
-    if (client->config.from_slot_set) {
-        request.has_from_slot = 1;
-        request.from_slot = client->config.from_slot;
+// Closes the events of one block so the writer can commit them as a unit.
+static void finish_block(const yurei_tx_view_t *block, size_t first, yurei_event_batch_t *out) {
+    if (out->count == first)
+        return;
+    metrics_inc_block_update(out->count - first);
+    yurei_event_t event = {0};
+    event.type = YUREI_EVENT_BLOCK_END;
+    event.data.block_end.slot = block->slot;
+    event.data.block_end.events = (uint32_t)(out->count - first);
+    dispatch_event(out, &event);
+}
+
+// Detects and parses every transaction of a scanned block in one pass.
+static void handle_block(geyser_stream_t *stream,
+                         const yurei_tx_view_t *block,
+                         uint64_t recv_ns,
+                         yurei_event_batch_t *out) {
+    if (!block->block_data)
+        return;
+    size_t first = out->count;
+    yurei_block_cursor_t cursor;
+    yurei_tx_view_t tx;
+    update_scanner_block_begin(block, &cursor);
+    while (update_scanner_block_next(&cursor, block, &tx))
+        handle_transaction(stream, &tx, recv_ns, out);
+    if (cursor.malformed)
+        LOG_WARN("malformed transaction in block %lu", (unsigned long)block->slot);
+    finish_block(block, first, out);
+}
+
+// Reports that a live stream reached `slot` at its commitment, so its
+// checkpoint source moves even when none of its programs are active.  The
+// status can overtake the slot's last transactions, so only the slot
+// before it counts as done.  Decode threads race to raise it.
+static void report_progress(geyser_stream_t *stream, const yurei_tx_view_t *view, yurei_event_batch_t *out) {
+    if (stream->backfill || !stream->client->checkpoint || view->slot < 2 ||
+        (int)view->slot_status != atomic_load_explicit(&stream->commitment, memory_order_relaxed))
+        return;
+    uint64_t done = view->slot - 1;
+    uint64_t current = atomic_load_explicit(&stream->progress_slot, memory_order_relaxed);
+    do {
+        if (done <= current)
+            return;
+    } while (!atomic_compare_exchange_weak(&stream->progress_slot, &current, done));
+    yurei_event_t event = {0};
+    event.type = YUREI_EVENT_SLOT_PROGRESS;
+    event.data.slot_update.slot = done;
+    dispatch_event(out, &event);
+}
+
+// Forwards the slot statuses the writer reconciles rows with.
+static void handle_slot_update(geyser_stream_t *stream, const yurei_tx_view_t *view,
+                               yurei_event_batch_t *out) {
+    if (!view->has_slot)
+        return;
+    // Every status counts as a sighting; replays are not live continuity
+    if (stream->client->slot_tracker && !stream->backfill)
+        slot_tracker_observe(stream->client->slot_tracker, view->slot,
+                             view->has_parent_slot ? view->parent_slot : 0);
+    report_progress(stream, view, out);
+    // Other streams follow slots only to feed the watchdog and gap tracker
+    if (!stream->track_slots)
+        return;
+    switch (view->slot_status) {
+    case YUREI_SLOT_CONFIRMED:
+    case YUREI_SLOT_FINALIZED:
+    case YUREI_SLOT_DEAD:
+        break;
+    default:
+        return;
+    }
+    yurei_event_t event = {0};
+    event.type = YUREI_EVENT_SLOT_STATUS;
+    event.data.slot_update.slot = view->slot;
+    event.data.slot_update.parent = view->has_parent_slot ? view->parent_slot : 0;
+    event.data.slot_update.status = (yurei_slot_status_t)view->slot_status;
+    dispatch_event(out, &event);
+}
+
+// Decodes a sliced state account of the stream's protocol.  The server
+// already applied owner, discriminator/size and slice filters, so the data
+// only has to be long enough for the fixed layout.
+static void handle_account(geyser_stream_t *stream, const yurei_tx_view_t *view, yurei_event_batch_t *out) {
+    if (!stream->account_updates || view->account_pubkey_len != 32 || !view->account_data)
+        return;
+    metrics_inc_account_update();
+    yurei_event_t event = {0};
+    bool decoded = false;
+    if (stream->protocols == YUREI_PROTOCOL_BIT(YUREI_PROTOCOL_PUMPFUN)) {
+        event.type = YUREI_EVENT_PUMPFUN_CURVE;
+        decoded = account_decode_pumpfun_curve(view->account_pubkey, view->account_data, view->account_data_len,
+                                               &event.data.pumpfun_curve);
+        event.data.pumpfun_curve.slot = view->has_slot ? view->slot : 0;
+        event.data.pumpfun_curve.write_version = view->write_version;
+    } else if (stream->protocols == YUREI_PROTOCOL_BIT(YUREI_PROTOCOL_RAYDIUM)) {
+        event.type = YUREI_EVENT_RAYDIUM_POOL;
+        decoded = account_decode_raydium_pool(view->account_pubkey, view->account_data, view->account_data_len,
+                                              &event.data.raydium_pool);
+        event.data.raydium_pool.slot = view->has_slot ? view->slot : 0;
+        event.data.raydium_pool.write_version = view->write_version;
     }
+    if (!decoded) {
+        metrics_inc_account_decode_error();
+        return;
+    }
+    event.commitment = (uint8_t)atomic_load_explicit(&stream->commitment, memory_order_relaxed);
+    dispatch_event(out, &event);
+}
 
-    char pumpfun_filter[64];
-    char raydium_filter[64];
-    char *account_includes[2];
-    size_t include_count = 0;
-    if (client->detector.pumpfun.enabled) {
-        if (base58_encode(client->detector.pumpfun.program_id, 32, pumpfun_filter, sizeof(pumpfun_filter)) > 0) {
-            account_includes[include_count++] = pumpfun_filter;
+// Attributes the update to every filter key it matched.
+static void record_filter_traffic(const yurei_tx_view_t *view) {
+    for (size_t i = 0; i < view->n_filters; ++i) {
+        for (size_t key = 0; key < GEYSER_FILTER_COUNT; ++key) {
+            if (view->filter_lens[i] == strlen(geyser_filter_keys[key]) &&
+                memcmp(view->filters[i], geyser_filter_keys[key], view->filter_lens[i]) == 0) {
+                metrics_record_filter_update(key, view->encoded_len);
+                break;
+            }
         }
     }
-    if (client->detector.raydium.enabled) {
-        if (base58_encode(client->detector.raydium.program_id, 32, raydium_filter, sizeof(raydium_filter)) > 0) {
-            account_includes[include_count++] = raydium_filter;
+}
+
+// Provider send -> local receive.  created_at is the provider's wall clock,
+// so the receive is mapped onto ours; clock skew below zero reads as 0.
+static void record_provider_latency(const yurei_tx_view_t *view, uint64_t recv_ns) {
+    if (!view->has_created_at)
+        return;
+    int64_t recv_wall_ns = metrics_wall_ns() - (int64_t)(metrics_now_ns() - recv_ns);
+    int64_t lag_ns = recv_wall_ns - view->created_at_ns;
+    metrics_record_provider_latency(lag_ns > 0 ? (uint64_t)lag_ns / 1000 : 0);
+}
+
+// Progress seen by the watchdog; decode threads race to raise it.
+static void note_slot(geyser_stream_t *stream, uint64_t slot) {
+    uint64_t current = atomic_load_explicit(&stream->latest_slot, memory_order_relaxed);
+    while (slot > current) {
+        if (atomic_compare_exchange_weak(&stream->latest_slot, &current, slot))
+            break;
+    }
+}
+
+// Carries the update's timestamps on the events decoded from it.  Backfill
+// events are only flagged: history would swamp the live latency histograms.
+static void stamp_events(const geyser_stream_t *stream, const yurei_tx_view_t *view, uint64_t recv_ns,
+                         size_t first, yurei_event_batch_t *out) {
+    if (stream->backfill) {
+        for (size_t i = first; i < out->count; ++i)
+            out->events[i].backfill = true;
+        return;
+    }
+    int64_t created_at_ns = view->has_created_at ? view->created_at_ns : 0;
+    for (size_t i = first; i < out->count; ++i) {
+        out->events[i].source = stream->checkpoint_source;
+        out->events[i].created_at_ns = created_at_ns;
+        out->events[i].recv_ns = recv_ns;
+    }
+}
+
+// Follows a backfill stream through its range.  Updates past the end are
+// dropped, and GEYSER_BACKFILL_TAIL_SLOTS later the stream is done.
+static bool backfill_accept(geyser_stream_t *stream, const yurei_tx_view_t *view) {
+    if (!view->has_slot)
+        return true;
+    if (view->slot >= stream->backfill_end) {
+        if (view->slot >= stream->backfill_end + GEYSER_BACKFILL_TAIL_SLOTS)
+            atomic_store(&stream->backfill_done, true);
+        return false;
+    }
+    uint64_t current = atomic_load_explicit(&stream->backfill_slot, memory_order_relaxed);
+    while (view->slot > current) {
+        if (atomic_compare_exchange_weak(&stream->backfill_slot, &current, view->slot)) {
+            if (!stream->repair)
+                metrics_add_backfill_progress(view->slot - current, 0);
+            break;
         }
     }
+    return true;
+}
 
-    Geyser__SubscribeRequest__TransactionsEntry tx_entry = GEYSER__SUBSCRIBE_REQUEST__TRANSACTIONS_ENTRY__INIT;
-    Geyser__SubscribeRequestFilterTransactions tx_filter = GEYSER__SUBSCRIBE_REQUEST_FILTER_TRANSACTIONS__INIT;
-    Geyser__SubscribeRequest__TransactionsEntry *tx_entries[1];
-    if (include_count > 0) {
-        tx_filter.account_include = account_includes;
-        tx_filter.n_account_include = include_count;
+static void handle_update(geyser_stream_t *stream,
+                          const yurei_tx_view_t *view,
+                          uint64_t recv_ns,
+                          yurei_event_batch_t *out) {
+    if (stream->backfill && !backfill_accept(stream, view))
+        return;
+    record_filter_traffic(view);
+    if (!stream->backfill)
+        record_provider_latency(view, recv_ns);
+    if (view->has_slot)
+        note_slot(stream, view->slot);
+    size_t first = out->count;
+    switch (view->kind) {
+    case YUREI_UPDATE_TRANSACTION:
+        handle_transaction(stream, view, recv_ns, out);
+        break;
+    case YUREI_UPDATE_SLOT:
+        handle_slot_update(stream, view, out);
+        break;
+    case YUREI_UPDATE_ACCOUNT:
+        handle_account(stream, view, out);
+        break;
+    case YUREI_UPDATE_BLOCK:
+        handle_block(stream, view, recv_ns, out);
+        break;
+    case YUREI_UPDATE_PING:
+        // Providers that ping expect the client to answer on the request half.
+        metrics_inc_server_ping();
+        atomic_store(&stream->ping_reply_due, true);
+        break;
+    case YUREI_UPDATE_PONG: {
+        int32_t expected = view->pong_id;
+        if (expected != 0 && atomic_compare_exchange_strong(&stream->ping_outstanding, &expected, 0)) {
+            uint64_t sent_ns = atomic_load(&stream->ping_sent_ns);
+            metrics_record_pong(recv_ns > sent_ns ? (recv_ns - sent_ns) / 1000 : 0);
+        }
+        break;
     }
-    if (include_count == 0) {
-        LOG_WARN("no protocol filters configured; subscribing to all transactions");
+    default:
+        break;
     }
+    stamp_events(stream, view, recv_ns, first, out);
+}
 
-    tx_entry.key = "transactions";
-    tx_entry.value = &tx_filter;
-    tx_entries[0] = &tx_entry;
-    request.n_transactions = 1;
-    request.transactions = tx_entries;
+static void tx_view_from_info(const Geyser__SubscribeUpdateTransactionInfo *info, yurei_tx_view_t *view);
+
+// Projects a fully unpacked update onto the same view the wire scanner
+// produces, so both decoders feed one detection/parsing path.
+static void tx_view_from_update(const Geyser__SubscribeUpdate *update, yurei_tx_view_t *view) {
+    view->kind = (yurei_update_kind_t)update->update_oneof_case;
+    view->encoded_len = 0;
+    view->n_filters = update->n_filters < YUREI_UPDATE_MAX_FILTERS ? update->n_filters : YUREI_UPDATE_MAX_FILTERS;
+    for (size_t i = 0; i < view->n_filters; ++i) {
+        view->filters[i] = update->filters[i];
+        view->filter_lens[i] = strlen(update->filters[i]);
+    }
+    view->has_created_at = update->created_at != NULL;
+    view->created_at_ns = update->created_at
+        ? update->created_at->seconds * 1000000000ll + update->created_at->nanos
+        : 0;
+    view->has_slot = false;
+    view->slot = 0;
+    view->signature = NULL;
+    view->signature_len = 0;
+    view->has_tx_index = false;
+    view->tx_index = 0;
+    view->n_account_keys = 0;
+    view->n_log_messages = 0;
+    view->truncated = false;
+    view->pong_id = 0;
+    view->parent_slot = 0;
+    view->has_parent_slot = false;
+    view->slot_status = 0;
+    view->account_pubkey = NULL;
+    view->account_pubkey_len = 0;
+    view->account_owner = NULL;
+    view->account_owner_len = 0;
+    view->account_data = NULL;
+    view->account_data_len = 0;
+    view->write_version = 0;
+    view->has_block_time = false;
+    view->block_time = 0;
+    view->block_data = NULL;
+    view->block_len = 0;
+    if (update->update_oneof_case == GEYSER__SUBSCRIBE_UPDATE__UPDATE_ONEOF_BLOCK && update->block) {
+        view->has_slot = update->block->has_slot;
+        view->slot = update->block->slot;
+        view->has_parent_slot = update->block->has_parent_slot;
+        view->parent_slot = update->block->parent_slot;
+        if (update->block->block_time && update->block->block_time->has_timestamp) {
+            view->has_block_time = true;
+            view->block_time = update->block->block_time->timestamp;
+        }
+    }
+    if (update->update_oneof_case == GEYSER__SUBSCRIBE_UPDATE__UPDATE_ONEOF_ACCOUNT && update->account) {
+        view->has_slot = update->account->has_slot;
+        view->slot = update->account->slot;
+        const Geyser__SubscribeUpdateAccountInfo *info = update->account->account;
+        if (info) {
+            if (info->has_pubkey) {
+                view->account_pubkey = info->pubkey.data;
+                view->account_pubkey_len = info->pubkey.len;
+            }
+            if (info->has_owner) {
+                view->account_owner = info->owner.data;
+                view->account_owner_len = info->owner.len;
+            }
+            if (info->has_data) {
+                view->account_data = info->data.data;
+                view->account_data_len = info->data.len;
+            }
+            view->write_version = info->write_version;
+        }
+    }
+    if (update->update_oneof_case == GEYSER__SUBSCRIBE_UPDATE__UPDATE_ONEOF_PONG && update->pong)
+        view->pong_id = update->pong->id;
+    if (update->update_oneof_case == GEYSER__SUBSCRIBE_UPDATE__UPDATE_ONEOF_SLOT && update->slot) {
+        view->has_slot = update->slot->has_slot;
+        view->slot = update->slot->slot;
+        view->has_parent_slot = update->slot->has_parent;
+        view->parent_slot = update->slot->parent;
+        view->slot_status = update->slot->has_status ? (int32_t)update->slot->status : 0;
+    }
+    if (update->update_oneof_case != GEYSER__SUBSCRIBE_UPDATE__UPDATE_ONEOF_TRANSACTION || !update->transaction)
+        return;
+    const Geyser__SubscribeUpdateTransaction *tx_update = update->transaction;
+    view->has_slot = tx_update->has_slot;
+    view->slot = tx_update->slot;
+    if (tx_update->transaction)
+        tx_view_from_info(tx_update->transaction, view);
+}
+
+static void tx_view_from_info(const Geyser__SubscribeUpdateTransactionInfo *info, yurei_tx_view_t *view) {
+    view->has_tx_index = info->has_index;
+    view->tx_index = info->index;
+    if (info->has_signature) {
+        view->signature = info->signature.data;
+        view->signature_len = info->signature.len;
+    }
+    const Solana__Storage__ConfirmedBlock__Transaction *sol_tx = info->transaction;
+    if (sol_tx && sol_tx->message && sol_tx->message->account_keys) {
+        const Solana__Storage__ConfirmedBlock__Message *msg = sol_tx->message;
+        size_t n = msg->n_account_keys;
+        if (n > YUREI_TX_MAX_ACCOUNTS) {
+            n = YUREI_TX_MAX_ACCOUNTS;
+            view->truncated = true;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            view->account_keys[i] = msg->account_keys[i].data;
+            view->account_key_lens[i] = msg->account_keys[i].len;
+        }
+        view->n_account_keys = n;
+    }
+    const Solana__Storage__ConfirmedBlock__TransactionStatusMeta *meta = info->meta;
+    if (meta && meta->log_messages) {
+        size_t n = meta->n_log_messages;
+        if (n > YUREI_TX_MAX_LOGS) {
+            n = YUREI_TX_MAX_LOGS;
+            view->truncated = true;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            view->log_messages[i] = meta->log_messages[i];
+            view->log_message_lens[i] = strlen(meta->log_messages[i]);
+        }
+        view->n_log_messages = n;
+    }
+}
+
+static bool tx_views_equal(const yurei_tx_view_t *a, const yurei_tx_view_t *b) {
+    if (a->kind != b->kind || a->has_slot != b->has_slot || a->slot != b->slot || a->pong_id != b->pong_id)
+        return false;
+    if (a->has_parent_slot != b->has_parent_slot || a->parent_slot != b->parent_slot ||
+        a->slot_status != b->slot_status)
+        return false;
+    if (a->has_tx_index != b->has_tx_index || a->tx_index != b->tx_index ||
+        a->has_block_time != b->has_block_time || a->block_time != b->block_time)
+        return false;
+    if (a->has_created_at != b->has_created_at || a->created_at_ns != b->created_at_ns)
+        return false;
+    if (a->write_version != b->write_version || a->account_pubkey_len != b->account_pubkey_len ||
+        a->account_data_len != b->account_data_len ||
+        (a->account_pubkey_len && memcmp(a->account_pubkey, b->account_pubkey, a->account_pubkey_len) != 0) ||
+        (a->account_data_len && memcmp(a->account_data, b->account_data, a->account_data_len) != 0))
+        return false;
+    if (a->n_filters != b->n_filters)
+        return false;
+    for (size_t i = 0; i < a->n_filters; ++i) {
+        if (a->filter_lens[i] != b->filter_lens[i] || memcmp(a->filters[i], b->filters[i], a->filter_lens[i]) != 0)
+            return false;
+    }
+    if (a->signature_len != b->signature_len ||
+        (a->signature_len && memcmp(a->signature, b->signature, a->signature_len) != 0))
+        return false;
+    if (a->n_account_keys != b->n_account_keys || a->n_log_messages != b->n_log_messages)
+        return false;
+    for (size_t i = 0; i < a->n_account_keys; ++i) {
+        if (a->account_key_lens[i] != b->account_key_lens[i] ||
+            memcmp(a->account_keys[i], b->account_keys[i], a->account_key_lens[i]) != 0)
+            return false;
+    }
+    for (size_t i = 0; i < a->n_log_messages; ++i) {
+        if (a->log_message_lens[i] != b->log_message_lens[i] ||
+            memcmp(a->log_messages[i], b->log_messages[i], a->log_message_lens[i]) != 0)
+            return false;
+    }
+    return true;
+}
+
+// Decodes with the generated protobuf-c code into the thread's arena.
+static void decode_generated(geyser_stream_t *stream,
+                             const uint8_t *data,
+                             size_t len,
+                             uint64_t recv_ns,
+                             const yurei_tx_view_t *scanned,
+                             yurei_event_batch_t *out) {
+    yurei_pb_arena_t *arena = pb_arena_thread_local();
+    ProtobufCAllocator *allocator = arena ? &arena->allocator : NULL;
+    Geyser__SubscribeUpdate *update = geyser__subscribe_update__unpack(allocator, len, data);
+    if (update) {
+        yurei_tx_view_t view;
+        tx_view_from_update(update, &view);
+        view.encoded_len = len;
+        if (scanned && !tx_views_equal(scanned, &view)) {
+            metrics_inc_decoder_mismatch();
+            LOG_WARN("wire scanner disagrees with generated decoder (slot %lu)", (unsigned long)view.slot);
+        }
+        if (view.kind == YUREI_UPDATE_BLOCK && update->block) {
+            record_filter_traffic(&view);
+            record_provider_latency(&view, recv_ns);
+            if (view.has_slot)
+                note_slot(stream, view.slot);
+            size_t first = out->count;
+            yurei_tx_view_t tx;
+            for (size_t i = 0; i < update->block->n_transactions; ++i) {
+                tx_view_from_update(update, &tx);
+                tx.kind = YUREI_UPDATE_TRANSACTION;
+                tx_view_from_info(update->block->transactions[i], &tx);
+                handle_transaction(stream, &tx, recv_ns, out);
+            }
+            finish_block(&view, first, out);
+            stamp_events(stream, &view, recv_ns, first, out);
+        } else {
+            handle_update(stream, &view, recv_ns, out);
+        }
+    }
+    if (arena)
+        pb_arena_reset(arena);
+    else if (update)
+        geyser__subscribe_update__free_unpacked(update, NULL);
+}
+
+typedef struct {
+    uint8_t *data;
+    size_t capacity;
+} scratch_buffer_t;
 
-    size_t packed = geyser__subscribe_request__get_packed_size(&request);
-    uint8_t *buffer = malloc(packed);
+static pthread_key_t g_scratch_key;
+static pthread_once_t g_scratch_once = PTHREAD_ONCE_INIT;
+
+static void scratch_release(void *ptr) {
+    scratch_buffer_t *scratch = ptr;
+    free(scratch->data);
+    free(scratch);
+}
+
+static void scratch_key_init(void) {
+    pthread_key_create(&g_scratch_key, scratch_release);
+}
+
+// Reusable per-thread buffer for messages that arrive split across slices.
+static scratch_buffer_t *thread_scratch(size_t needed) {
+    pthread_once(&g_scratch_once, scratch_key_init);
+    scratch_buffer_t *scratch = pthread_getspecific(g_scratch_key);
+    if (!scratch) {
+        scratch = calloc(1, sizeof(*scratch));
+        if (!scratch)
+            return NULL;
+        pthread_setspecific(g_scratch_key, scratch);
+    }
+    if (needed > scratch->capacity) {
+        size_t capacity = scratch->capacity ? scratch->capacity : 64 * 1024;
+        while (capacity < needed)
+            capacity *= 2;
+        uint8_t *grown = realloc(scratch->data, capacity);
+        if (!grown)
+            return NULL;
+        scratch->data = grown;
+        scratch->capacity = capacity;
+    }
+    return scratch;
+}
+
+// Returns a contiguous view of a received message.  An uncompressed buffer
+// backed by a single slice is read in place; anything else is gathered into
+// the calling thread's scratch buffer.  The view is valid until the byte
+// buffer is destroyed or the thread gathers the next message.
+static bool message_bytes(grpc_byte_buffer *bb, const uint8_t **data, size_t *len) {
+    if (bb->type == GRPC_BB_RAW && bb->data.raw.compression == GRPC_COMPRESS_NONE &&
+        bb->data.raw.slice_buffer.count == 1) {
+        const grpc_slice *slice = &bb->data.raw.slice_buffer.slices[0];
+        *data = GRPC_SLICE_START_PTR(*slice);
+        *len = GRPC_SLICE_LENGTH(*slice);
+        metrics_inc_recv_single_slice();
+        metrics_add_recv_bytes(*len, *len, false);
+        return true;
+    }
+    size_t wire_len = grpc_byte_buffer_length(bb);
+    bool compressed = bb->type == GRPC_BB_RAW && bb->data.raw.compression != GRPC_COMPRESS_NONE;
+    grpc_byte_buffer_reader reader;
+    if (!grpc_byte_buffer_reader_init(&reader, bb))
+        return false;
+    scratch_buffer_t *scratch = thread_scratch(wire_len);
+    size_t total = 0;
+    grpc_slice slice;
+    bool ok = scratch != NULL;
+    while (grpc_byte_buffer_reader_next(&reader, &slice)) {
+        size_t n = GRPC_SLICE_LENGTH(slice);
+        // Compressed buffers inflate while being read, so keep growing.
+        if (ok && total + n > scratch->capacity)
+            ok = thread_scratch(total + n) != NULL;
+        if (ok)
+            memcpy(scratch->data + total, GRPC_SLICE_START_PTR(slice), n);
+        total += n;
+        grpc_slice_unref(slice);
+    }
+    grpc_byte_buffer_reader_destroy(&reader);
+    if (!ok)
+        return false;
+    *data = scratch->data;
+    *len = total;
+    metrics_inc_recv_multi_slice(total);
+    metrics_add_recv_bytes(wire_len, total, compressed);
+    return true;
+}
+
+// Decode stage shared by the inline path and the pipeline workers.  Takes
+// ownership of the received byte buffer.  The wire scanner reads the handful
+// of fields the pipeline needs straight from the received bytes; the
+// generated decoder is kept as a fallback and for cross-checking.
+static void decode_message(void *ctx, void *message, uint64_t recv_ns, yurei_event_batch_t *out) {
+    geyser_stream_t *stream = ctx;
+    struct geyser_client *client = stream->client;
+    grpc_byte_buffer *recv_buffer = message;
+    const uint8_t *data = NULL;
+    size_t len = 0;
+    if (!message_bytes(recv_buffer, &data, &len)) {
+        LOG_WARN("failed to read received message (%zu bytes)", grpc_byte_buffer_length(recv_buffer));
+        grpc_byte_buffer_destroy(recv_buffer);
+        return;
+    }
+    if (client->recorder && !stream->backfill) {
+        int64_t recv_wall_ns = metrics_wall_ns() - (int64_t)(metrics_now_ns() - recv_ns);
+        stream_recorder_write(client->recorder, recv_wall_ns, data, len);
+    }
+
+    switch (client->config.decoder_mode) {
+    case YUREI_DECODER_SCANNER: {
+        yurei_tx_view_t view;
+        if (update_scanner_scan(data, len, &view)) {
+            handle_update(stream, &view, recv_ns, out);
+        } else {
+            metrics_inc_scanner_fallback();
+            decode_generated(stream, data, len, recv_ns, NULL, out);
+        }
+        break;
+    }
+    case YUREI_DECODER_CROSSCHECK: {
+        yurei_tx_view_t view;
+        bool scanned = update_scanner_scan(data, len, &view);
+        if (!scanned)
+            metrics_inc_scanner_fallback();
+        decode_generated(stream, data, len, recv_ns, scanned ? &view : NULL, out);
+        break;
+    }
+    case YUREI_DECODER_GENERATED:
+    default:
+        decode_generated(stream, data, len, recv_ns, NULL, out);
+        break;
+    }
+
+    grpc_byte_buffer_destroy(recv_buffer);
+}
+
+static grpc_byte_buffer *pack_subscribe_request(const Geyser__SubscribeRequest *request) {
+    size_t packed = geyser__subscribe_request__get_packed_size(request);
+    uint8_t *buffer = malloc(packed ? packed : 1);
     if (!buffer)
         return NULL;
-    geyser__subscribe_request__pack(&request, buffer);
+    geyser__subscribe_request__pack(request, buffer);
     grpc_slice slice = grpc_slice_from_copied_buffer((const char *)buffer, packed);
     grpc_byte_buffer *bb = grpc_raw_byte_buffer_create(&slice, 1);
     grpc_slice_unref(slice);
@@ -293,11 +971,797 @@ static grpc_byte_buffer *build_subscribe_payload(const struct geyser_client *cli
     return bb;
 }
 
-static bool run_subscription(struct geyser_client *client) {
-    grpc_channel_credentials *creds = grpc_ssl_credentials_create(NULL, NULL, NULL, NULL);
-    grpc_channel *channel = grpc_channel_create(client->config.endpoint, creds, NULL);
+// A request carrying only `ping` leaves the stream's filters untouched.
+static grpc_byte_buffer *build_ping_payload(int32_t id) {
+    Geyser__SubscribeRequest request = GEYSER__SUBSCRIBE_REQUEST__INIT;
+    Geyser__SubscribeRequestPing ping = GEYSER__SUBSCRIBE_REQUEST_PING__INIT;
+    ping.has_id = 1;
+    ping.id = id;
+    request.ping = &ping;
+    return pack_subscribe_request(&request);
+}
+
+// Program shards may override the commitment level; everything else uses
+// the current filters' level.
+static yurei_commitment_t stream_commitment(const geyser_stream_t *stream, const geyser_filters_t *filters) {
+    const yurei_config_t *config = &stream->client->config;
+    if (stream->protocols == YUREI_PROTOCOL_BIT(YUREI_PROTOCOL_PUMPFUN) &&
+        config->pumpfun_commitment != config->commitment)
+        return config->pumpfun_commitment;
+    if (stream->protocols == YUREI_PROTOCOL_BIT(YUREI_PROTOCOL_RAYDIUM) &&
+        config->raydium_commitment != config->commitment)
+        return config->raydium_commitment;
+    return filters->commitment;
+}
+
+// Storage for one protocol's transaction filter while the request is packed.
+typedef struct {
+    Geyser__SubscribeRequest__TransactionsEntry entry;
+    Geyser__SubscribeRequestFilterTransactions filter;
+    char programs[YUREI_DETECTOR_MAX_PROGRAMS][YUREI_PUBKEY_B58_MAX];
+    char *account_include[YUREI_DETECTOR_MAX_PROGRAMS];
+    char *account_exclude[YUREI_MAX_FILTER_ACCOUNTS];
+    char *account_required[YUREI_MAX_FILTER_ACCOUNTS];
+} geyser_tx_filter_t;
+
+static void set_tx_flag(yurei_tx_flag_t flag, protobuf_c_boolean *has, protobuf_c_boolean *value) {
+    *has = flag != YUREI_TX_FLAG_INCLUDE;
+    *value = flag == YUREI_TX_FLAG_ONLY;
+}
+
+// The filter includes every registered program of the protocol; false when
+// the protocol has none.
+static bool init_tx_filter(geyser_tx_filter_t *out,
+                           size_t key,
+                           const yurei_protocol_detector_t *detector,
+                           yurei_protocol_t protocol,
+                           const yurei_tx_filter_config_t *config) {
+    const uint8_t *program_ids[YUREI_DETECTOR_MAX_PROGRAMS];
+    size_t n_programs = protocol_detector_programs(detector, protocol, program_ids, YUREI_DETECTOR_MAX_PROGRAMS);
+    if (n_programs == 0)
+        return false;
+    for (size_t i = 0; i < n_programs; ++i) {
+        if (base58_encode(program_ids[i], 32, out->programs[i], sizeof(out->programs[i])) <= 0)
+            return false;
+        out->account_include[i] = out->programs[i];
+    }
+    out->entry = (Geyser__SubscribeRequest__TransactionsEntry)GEYSER__SUBSCRIBE_REQUEST__TRANSACTIONS_ENTRY__INIT;
+    out->filter = (Geyser__SubscribeRequestFilterTransactions)GEYSER__SUBSCRIBE_REQUEST_FILTER_TRANSACTIONS__INIT;
+    out->filter.account_include = out->account_include;
+    out->filter.n_account_include = n_programs;
+    // The config strings outlive the request, so they are referenced as is.
+    for (size_t i = 0; i < config->n_account_exclude; ++i)
+        out->account_exclude[i] = (char *)config->account_exclude[i];
+    out->filter.account_exclude = out->account_exclude;
+    out->filter.n_account_exclude = config->n_account_exclude;
+    for (size_t i = 0; i < config->n_account_required; ++i)
+        out->account_required[i] = (char *)config->account_required[i];
+    out->filter.account_required = out->account_required;
+    out->filter.n_account_required = config->n_account_required;
+    set_tx_flag(config->vote, &out->filter.has_vote, &out->filter.vote);
+    set_tx_flag(config->failed, &out->filter.has_failed, &out->filter.failed);
+    out->entry.key = (char *)geyser_filter_keys[key];
+    out->entry.value = &out->filter;
+    return true;
+}
+
+// Account stream request: the protocol's state accounts selected by owner
+// plus a discriminator (PumpFun) or data size (Raydium) filter, with the
+// data sliced down to the fields the account decoder reads.
+static grpc_byte_buffer *pack_accounts_request(const geyser_stream_t *stream,
+                                               const yurei_protocol_detector_t *detector,
+                                               Geyser__SubscribeRequest *request) {
+    bool pumpfun = stream->protocols == YUREI_PROTOCOL_BIT(YUREI_PROTOCOL_PUMPFUN);
+    const yurei_account_layout_t *layout = pumpfun ? &account_layout_pumpfun_curve : &account_layout_raydium_pool;
+    const uint8_t *program_ids[YUREI_DETECTOR_MAX_PROGRAMS];
+    size_t n_owners = protocol_detector_programs(detector, pumpfun ? YUREI_PROTOCOL_PUMPFUN : YUREI_PROTOCOL_RAYDIUM,
+                                                 program_ids, YUREI_DETECTOR_MAX_PROGRAMS);
+    char owner_b58[YUREI_DETECTOR_MAX_PROGRAMS][YUREI_PUBKEY_B58_MAX];
+    char *owners[YUREI_DETECTOR_MAX_PROGRAMS];
+    for (size_t i = 0; i < n_owners; ++i) {
+        if (base58_encode(program_ids[i], 32, owner_b58[i], sizeof(owner_b58[i])) <= 0)
+            n_owners = 0;
+        else
+            owners[i] = owner_b58[i];
+    }
+    // A disabled program leaves the stream idle, like a program shard.
+    if (n_owners == 0)
+        return pack_subscribe_request(request);
+
+    Geyser__SubscribeRequestFilterAccountsFilterMemcmp memcmp_filter;
+    geyser__subscribe_request_filter_accounts_filter_memcmp__init(&memcmp_filter);
+    Geyser__SubscribeRequestFilterAccountsFilter data_filter = GEYSER__SUBSCRIBE_REQUEST_FILTER_ACCOUNTS_FILTER__INIT;
+    if (pumpfun) {
+        memcmp_filter.has_offset = 1;
+        memcmp_filter.offset = 0;
+        memcmp_filter.data_case = GEYSER__SUBSCRIBE_REQUEST_FILTER_ACCOUNTS_FILTER_MEMCMP__DATA_BYTES;
+        memcmp_filter.bytes.data = (uint8_t *)account_decoder_pumpfun_curve_discriminator;
+        memcmp_filter.bytes.len = sizeof(account_decoder_pumpfun_curve_discriminator);
+        data_filter.filter_case = GEYSER__SUBSCRIBE_REQUEST_FILTER_ACCOUNTS_FILTER__FILTER_MEMCMP;
+        data_filter.memcmp = &memcmp_filter;
+    } else {
+        data_filter.filter_case = GEYSER__SUBSCRIBE_REQUEST_FILTER_ACCOUNTS_FILTER__FILTER_DATASIZE;
+        data_filter.datasize = YUREI_RAYDIUM_AMM_INFO_SIZE;
+    }
+    Geyser__SubscribeRequestFilterAccountsFilter *data_filters[1] = {&data_filter};
+
+    Geyser__SubscribeRequestFilterAccounts accounts_filter = GEYSER__SUBSCRIBE_REQUEST_FILTER_ACCOUNTS__INIT;
+    accounts_filter.owner = owners;
+    accounts_filter.n_owner = n_owners;
+    accounts_filter.filters = data_filters;
+    accounts_filter.n_filters = 1;
+    Geyser__SubscribeRequest__AccountsEntry entry = GEYSER__SUBSCRIBE_REQUEST__ACCOUNTS_ENTRY__INIT;
+    entry.key = (char *)geyser_filter_keys[pumpfun ? GEYSER_FILTER_PUMPFUN_CURVES : GEYSER_FILTER_RAYDIUM_POOLS];
+    entry.value = &accounts_filter;
+    Geyser__SubscribeRequest__AccountsEntry *entries[1] = {&entry};
+    request->accounts = entries;
+    request->n_accounts = 1;
+
+    Geyser__SubscribeRequestAccountsDataSlice slices[YUREI_ACCOUNT_MAX_SLICES];
+    Geyser__SubscribeRequestAccountsDataSlice *slice_ptrs[YUREI_ACCOUNT_MAX_SLICES];
+    for (size_t i = 0; i < layout->n_slices; ++i) {
+        slices[i] = (Geyser__SubscribeRequestAccountsDataSlice)GEYSER__SUBSCRIBE_REQUEST_ACCOUNTS_DATA_SLICE__INIT;
+        slices[i].has_offset = 1;
+        slices[i].offset = layout->slices[i].offset;
+        slices[i].has_length = 1;
+        slices[i].length = layout->slices[i].length;
+        slice_ptrs[i] = &slices[i];
+    }
+    request->accounts_data_slice = slice_ptrs;
+    request->n_accounts_data_slice = layout->n_slices;
+    return pack_subscribe_request(request);
+}
+
+// Block ingest: one blocks filter carrying the programs of the transaction
+// filters, so each update holds every matching transaction of a slot.  The
+// vote/failed/account narrowing has no equivalent on block filters.
+static grpc_byte_buffer *pack_blocks_request(Geyser__SubscribeRequest *request,
+                                             geyser_tx_filter_t *tx_filters,
+                                             size_t n_tx) {
+    // A program belongs to one protocol, so the filters never hold more than
+    // the registry does.
+    char *programs[YUREI_DETECTOR_MAX_PROGRAMS];
+    size_t n_programs = 0;
+    for (size_t i = 0; i < n_tx; ++i) {
+        for (size_t p = 0; p < tx_filters[i].filter.n_account_include; ++p)
+            programs[n_programs++] = tx_filters[i].account_include[p];
+    }
+    if (n_tx == 0)
+        LOG_WARN("no protocol filters configured; subscribing to every transaction of every block");
+    Geyser__SubscribeRequestFilterBlocks blocks_filter = GEYSER__SUBSCRIBE_REQUEST_FILTER_BLOCKS__INIT;
+    blocks_filter.account_include = programs;
+    blocks_filter.n_account_include = n_programs;
+    blocks_filter.has_include_transactions = 1;
+    blocks_filter.include_transactions = 1;
+    blocks_filter.has_include_accounts = 1;
+    blocks_filter.include_accounts = 0;
+    blocks_filter.has_include_entries = 1;
+    blocks_filter.include_entries = 0;
+    Geyser__SubscribeRequest__BlocksEntry entry = GEYSER__SUBSCRIBE_REQUEST__BLOCKS_ENTRY__INIT;
+    entry.key = (char *)geyser_filter_keys[GEYSER_FILTER_BLOCKS];
+    entry.value = &blocks_filter;
+    Geyser__SubscribeRequest__BlocksEntry *entries[1] = {&entry};
+    request->blocks = entries;
+    request->n_blocks = 1;
+    return pack_subscribe_request(request);
+}
+
+// `initial` requests carry from_slot; replacements sent on a live call only
+// change filters.
+static grpc_byte_buffer *build_subscribe_payload(geyser_stream_t *stream, bool initial) {
+    struct geyser_client *client = stream->client;
+    const geyser_filters_t *filters = atomic_load_explicit(&client->filters, memory_order_acquire);
+    const yurei_protocol_detector_t *detector = &filters->detector;
+    stream->filters_generation = filters->generation;
+    yurei_commitment_t commitment = stream_commitment(stream, filters);
+    atomic_store(&stream->commitment, (int)commitment);
+    Geyser__SubscribeRequest request = GEYSER__SUBSCRIBE_REQUEST__INIT;
+    request.has_commitment = 1;
+    request.commitment = (Geyser__CommitmentLevel)commitment;
+
+    // Every slot status, independent of the stream's commitment, so rows
+    // written early can be promoted or flagged dead.  With the watchdog or a
+    // checkpoint on, the other streams follow slots at their commitment as a
+    // heartbeat, to show the gap tracker which slots went by and to move
+    // their checkpoint source while their programs are quiet.
+    Geyser__SubscribeRequest__SlotsEntry slots_entry = GEYSER__SUBSCRIBE_REQUEST__SLOTS_ENTRY__INIT;
+    Geyser__SubscribeRequestFilterSlots slots_filter = GEYSER__SUBSCRIBE_REQUEST_FILTER_SLOTS__INIT;
+    Geyser__SubscribeRequest__SlotsEntry *slots_entries[1];
+    if (stream->track_slots || stream->backfill || client->slot_tracker || client->checkpoint ||
+        client->config.watchdog_interval_ms > 0) {
+        slots_filter.has_filter_by_commitment = 1;
+        slots_filter.filter_by_commitment = !stream->track_slots;
+        slots_entry.key = (char *)geyser_filter_keys[GEYSER_FILTER_SLOTS];
+        slots_entry.value = &slots_filter;
+        slots_entries[0] = &slots_entry;
+        request.n_slots = 1;
+        request.slots = slots_entries;
+    }
+    if (initial && stream->from_slot_set) {
+        request.has_from_slot = 1;
+        request.from_slot = stream->from_slot;
+    }
+    if (stream->account_updates)
+        return pack_accounts_request(stream, detector, &request);
+
+    // One transaction filter per protocol, keyed by protocol name so the
+    // filters field of each update attributes it to the protocol it matched.
+    geyser_tx_filter_t tx_filters[2];
+    Geyser__SubscribeRequest__TransactionsEntry *tx_entries[2];
+    size_t n_tx = 0;
+    if ((stream->protocols & YUREI_PROTOCOL_BIT(YUREI_PROTOCOL_PUMPFUN)) &&
+        init_tx_filter(&tx_filters[n_tx], GEYSER_FILTER_PUMPFUN, detector, YUREI_PROTOCOL_PUMPFUN,
+                       &client->config.pumpfun_filter)) {
+        tx_entries[n_tx] = &tx_filters[n_tx].entry;
+        n_tx++;
+    }
+    if ((stream->protocols & YUREI_PROTOCOL_BIT(YUREI_PROTOCOL_RAYDIUM)) &&
+        init_tx_filter(&tx_filters[n_tx], GEYSER_FILTER_RAYDIUM, detector, YUREI_PROTOCOL_RAYDIUM,
+                       &client->config.raydium_filter)) {
+        tx_entries[n_tx] = &tx_filters[n_tx].entry;
+        n_tx++;
+    }
+    if (n_tx == 0 && stream->protocols != YUREI_PROTOCOL_ALL) {
+        // A program shard whose program was disabled idles with no filters
+        // rather than falling back to every transaction.
+        return pack_subscribe_request(&request);
+    }
+    // Backfill always replays transactions: its rows are not written as
+    // per-block transactions, so whole blocks would only cost bandwidth.
+    if (client->config.ingest_mode == YUREI_INGEST_BLOCKS && !stream->backfill)
+        return pack_blocks_request(&request, tx_filters, n_tx);
+    if (n_tx == 0) {
+        LOG_WARN("no protocol filters configured; subscribing to all transactions");
+        tx_filters[0].entry = (Geyser__SubscribeRequest__TransactionsEntry)GEYSER__SUBSCRIBE_REQUEST__TRANSACTIONS_ENTRY__INIT;
+        tx_filters[0].filter = (Geyser__SubscribeRequestFilterTransactions)GEYSER__SUBSCRIBE_REQUEST_FILTER_TRANSACTIONS__INIT;
+        tx_filters[0].entry.key = (char *)geyser_filter_keys[GEYSER_FILTER_ALL];
+        tx_filters[0].entry.value = &tx_filters[0].filter;
+        tx_entries[n_tx++] = &tx_filters[0].entry;
+    }
+
+    request.n_transactions = n_tx;
+    request.transactions = tx_entries;
+    return pack_subscribe_request(&request);
+}
+
+static bool call_start_op(geyser_call_state_t *state, geyser_call_op_t *op, const grpc_op *ops, size_t nops) {
+    if (grpc_call_start_batch(state->call, ops, nops, op, NULL) != GRPC_CALL_OK)
+        return false;
+    op->pending = true;
+    return true;
+}
+
+static bool call_ops_pending(const geyser_call_state_t *state) {
+    return state->start_op.pending || state->status_op.pending || state->recv_op.pending ||
+           state->send_op.pending || state->probe_op.pending;
+}
+
+// Waits up to `ms` for one completion and runs its callback.  Returns false
+// once the queue is shut down.
+static bool call_dispatch(geyser_call_state_t *state, int ms) {
+    grpc_event ev = state->busy_poll ? cq_spin(state->cq, ms) : cq_next(state->cq, ms);
+    if (ev.type == GRPC_QUEUE_SHUTDOWN)
+        return false;
+    if (ev.type != GRPC_OP_COMPLETE)
+        return true;
+    geyser_call_op_t *op = ev.tag;
+    op->pending = false;
+    op->on_complete(state, ev.success != 0);
+    return true;
+}
+
+// Starts a send on the request half.  The buffer is owned by the call state
+// until the send completes.
+static bool start_send(geyser_call_state_t *state, grpc_byte_buffer *payload) {
+    grpc_op op;
+    op.op = GRPC_OP_SEND_MESSAGE;
+    op.data.send_message.send_message = payload;
+    op.flags = 0;
+    op.reserved = NULL;
+    if (!call_start_op(state, &state->send_op, &op, 1)) {
+        grpc_byte_buffer_destroy(payload);
+        return false;
+    }
+    state->send_buffer = payload;
+    return true;
+}
+
+// Sends a keepalive ping (or the answer to a server ping).
+static bool send_ping(geyser_call_state_t *state) {
+    geyser_stream_t *stream = state->stream;
+    int32_t id = ++stream->next_ping_id;
+    if (id <= 0)
+        id = stream->next_ping_id = 1;
+    grpc_byte_buffer *payload = build_ping_payload(id);
+    if (!payload)
+        return false;
+    atomic_store(&stream->ping_sent_ns, metrics_now_ns());
+    atomic_store(&stream->ping_outstanding, id);
+    if (!start_send(state, payload)) {
+        atomic_store(&stream->ping_outstanding, 0);
+        return false;
+    }
+    metrics_inc_ping_sent();
+    return true;
+}
+
+// Replaces the call's filters when a newer snapshot has been published.
+// The server applies a full SubscribeRequest in place of the previous one.
+static bool send_filters_if_changed(geyser_call_state_t *state) {
+    geyser_stream_t *stream = state->stream;
+    const geyser_filters_t *filters = atomic_load_explicit(&stream->client->filters, memory_order_acquire);
+    if (filters->generation == stream->filters_generation)
+        return true;
+    grpc_byte_buffer *payload = build_subscribe_payload(stream, false);
+    if (!payload)
+        return false;
+    if (!start_send(state, payload))
+        return false;
+    LOG_INFO("%s: applied filter generation %lu", stream->name, (unsigned long)stream->filters_generation);
+    return true;
+}
+
+static void deliver_message(geyser_stream_t *stream, grpc_byte_buffer *recv_buffer, bool *ok) {
+    struct geyser_client *client = stream->client;
+    uint64_t recv_ns = metrics_now_ns();
+    // Backfill decodes on its own thread: the shared pipeline releases in
+    // submission order, so a backfill batch waiting on its lane would hold
+    // up live messages behind it.
+    if (client->pipeline && !stream->backfill) {
+        if (!ingest_pipeline_submit(client->pipeline, recv_buffer, stream, recv_ns)) {
+            grpc_byte_buffer_destroy(recv_buffer);
+            *ok = false;
+        }
+        return;
+    }
+    decode_message(stream, recv_buffer, recv_ns, &stream->inline_batch);
+    yurei_event_batch_t *batch = &stream->inline_batch;
+    bool pushed;
+    if (stream->backfill) {
+        if (!stream->repair)
+            metrics_add_backfill_progress(0, batch->count);
+        pushed = event_queue_push_backfill(client->queue, batch->events, batch->count);
+    } else {
+        pushed = event_queue_push_batch(client->queue, batch->events, batch->count);
+    }
+    if (!pushed)
+        LOG_WARN("dropping %zu events because queue is unavailable", batch->count);
+    event_batch_reset(batch);
+}
+
+// gRPC allows one receive in flight per call.  The next one is started
+// before the message is decoded, so the transport reads ahead while this
+// thread (or the pipeline) works on the current one.
+static bool start_recv(geyser_call_state_t *state) {
+    grpc_op op;
+    op.op = GRPC_OP_RECV_MESSAGE;
+    op.data.recv_message.recv_message = &state->recv_buffer;
+    op.flags = 0;
+    op.reserved = NULL;
+    return call_start_op(state, &state->recv_op, &op, 1);
+}
+
+static void on_start_complete(geyser_call_state_t *state, bool success) {
+    grpc_byte_buffer_destroy(state->start_payload);
+    state->start_payload = NULL;
+    state->handshake_ok = success;
+    if (!success) {
+        LOG_ERROR("%s: failed to establish subscription", state->stream->name);
+        state->call_ok = false;
+        return;
+    }
+    if (!start_recv(state))
+        state->call_ok = false;
+}
+
+static void on_status_complete(geyser_call_state_t *state, bool success) {
+    state->status_received = success;
+}
+
+static void on_recv_complete(geyser_call_state_t *state, bool success) {
+    grpc_byte_buffer *message = state->recv_buffer;
+    state->recv_buffer = NULL;
+    if (!success || message == NULL) {
+        if (message)
+            grpc_byte_buffer_destroy(message);
+        state->recv_closed = true;
+        state->call_ok = false;
+        return;
+    }
+    geyser_stream_t *stream = state->stream;
+    if (!state->call_ok || !stream->client->running) {
+        grpc_byte_buffer_destroy(message);
+        return;
+    }
+    if (!start_recv(state))
+        state->call_ok = false;
+    state->received_any = true;
+    if (stream->ended_ns != 0) {
+        metrics_record_reconnect((metrics_now_ns() - stream->ended_ns) / 1000);
+        stream->ended_ns = 0;
+    }
+    deliver_message(stream, message, &state->call_ok);
+}
+
+static void on_send_complete(geyser_call_state_t *state, bool success) {
+    grpc_byte_buffer_destroy(state->send_buffer);
+    state->send_buffer = NULL;
+    if (!success)
+        state->call_ok = false;
+}
+
+static void release_channel(geyser_stream_t *stream) {
+    destroy_completion_queue(stream->cq);
+    stream->cq = NULL;
+    if (stream->channel)
+        grpc_channel_destroy(stream->channel);
+    stream->channel = NULL;
+    if (stream->creds)
+        grpc_channel_credentials_release(stream->creds);
+    stream->creds = NULL;
+}
+
+static void add_int_arg(grpc_arg *args, size_t *n, const char *key, int value) {
+    args[*n].type = GRPC_ARG_INTEGER;
+    args[*n].key = (char *)key;
+    args[*n].value.integer = value;
+    (*n)++;
+}
+
+// Channel arguments from the YUREI_GRPC_* knobs.  Per-message decompression
+// is turned off so compressed messages reach message_bytes as received and
+// are inflated on the decode thread instead of the receive thread.
+static size_t build_channel_args(const yurei_config_t *config, grpc_arg *args) {
+    size_t n = 0;
+    if (config->grpc_max_recv_bytes != 0)
+        add_int_arg(args, &n, GRPC_ARG_MAX_RECEIVE_MESSAGE_LENGTH, config->grpc_max_recv_bytes);
+    add_int_arg(args, &n, GRPC_ARG_HTTP2_BDP_PROBE, config->grpc_bdp_probe ? 1 : 0);
+    if (config->grpc_stream_window_bytes > 0)
+        add_int_arg(args, &n, GRPC_ARG_HTTP2_STREAM_LOOKAHEAD_BYTES, config->grpc_stream_window_bytes);
+    if (config->grpc_max_frame_bytes > 0)
+        add_int_arg(args, &n, GRPC_ARG_HTTP2_MAX_FRAME_SIZE, config->grpc_max_frame_bytes);
+    if (config->grpc_keepalive_ms > 0) {
+        add_int_arg(args, &n, GRPC_ARG_KEEPALIVE_TIME_MS, config->grpc_keepalive_ms);
+        add_int_arg(args, &n, GRPC_ARG_KEEPALIVE_TIMEOUT_MS, config->grpc_keepalive_timeout_ms);
+        add_int_arg(args, &n, GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS, 1);
+        add_int_arg(args, &n, GRPC_ARG_HTTP2_MAX_PINGS_WITHOUT_DATA, 0);
+    }
+    int encodings = 1 << GRPC_COMPRESS_NONE;
+    if (config->grpc_accept_encodings & YUREI_ENCODING_GZIP)
+        encodings |= 1 << GRPC_COMPRESS_GZIP;
+    if (config->grpc_accept_encodings & YUREI_ENCODING_DEFLATE)
+        encodings |= 1 << GRPC_COMPRESS_DEFLATE;
+    add_int_arg(args, &n, GRPC_COMPRESSION_CHANNEL_ENABLED_ALGORITHMS_BITSET, encodings);
+    add_int_arg(args, &n, GRPC_ARG_ENABLE_PER_MESSAGE_DECOMPRESSION, 0);
+    return n;
+}
+
+// gRPC's own threads (executor, timers, resolver) inherit the CPU mask of
+// the thread that happens to start them.  Whatever may start one runs with
+// the caller moved onto YUREI_GRPC_CPUS, keeping them off the ingest cores.
+static bool enter_grpc_cpus(const yurei_config_t *config, yurei_cpu_list_t *saved) {
+    if (config->grpc_cpus.count == 0 || !topology_current_cpus(saved))
+        return false;
+    return topology_bind_thread(pthread_self(), &config->grpc_cpus);
+}
+
+// Channel, credentials and completion queue outlive individual calls; only
+// a run of failed attempts (e.g. the endpoint moved) forces a fresh channel.
+static bool ensure_channel(geyser_stream_t *stream) {
+    if (stream->channel && stream->failed_attempts >= GEYSER_CHANNEL_RESET_ATTEMPTS) {
+        LOG_WARN("%s: %u failed attempts, rebuilding channel", stream->name, stream->failed_attempts);
+        release_channel(stream);
+        stream->failed_attempts = 0;
+    }
+    if (stream->channel)
+        return true;
+    grpc_arg args[GEYSER_MAX_CHANNEL_ARGS];
+    grpc_channel_args channel_args = {.num_args = build_channel_args(&stream->client->config, args), .args = args};
+    yurei_cpu_list_t own_cpus;
+    bool moved = enter_grpc_cpus(&stream->client->config, &own_cpus);
+    stream->creds = grpc_ssl_credentials_create(NULL, NULL, NULL, NULL);
+    stream->channel = grpc_channel_create(stream->endpoint.endpoint, stream->creds, &channel_args);
+    stream->cq = grpc_completion_queue_create_for_next(NULL);
+    if (moved)
+        topology_bind_thread(pthread_self(), &own_cpus);
+    if (!stream->creds || !stream->channel || !stream->cq) {
+        release_channel(stream);
+        return false;
+    }
+    return true;
+}
+
+// Resumes from what the stream's shard committed, rewound a few slots because
+// streams deliver slots slightly out of order; replayed rows are dropped by
+// the writer's ON CONFLICT.  An explicit YUREI_RESUME_FROM_SLOT past the
+// checkpoint is kept.
+static void refresh_resume_slot(geyser_stream_t *stream) {
+    struct geyser_client *client = stream->client;
+    if (stream->backfill) {
+        // A backfill call that dropped picks up where it got to
+        uint64_t reached = atomic_load(&stream->backfill_slot);
+        uint64_t rewind = client->config.checkpoint_rewind;
+        uint64_t resume = reached > stream->backfill_start + rewind ? reached - rewind : stream->backfill_start;
+        if (stream->from_slot_set && resume > stream->from_slot)
+            stream->from_slot = resume;
+        return;
+    }
+    if (!client->checkpoint || stream->replay_rejected)
+        return;
+    uint64_t committed = checkpoint_source_slot(client->checkpoint, stream->checkpoint_source);
+    if (committed == 0)
+        return;
+    uint64_t rewind = client->config.checkpoint_rewind;
+    uint64_t resume = committed > rewind ? committed - rewind : 1;
+    if (!stream->from_slot_set || resume > stream->from_slot) {
+        stream->from_slot = resume;
+        stream->from_slot_set = true;
+    }
+}
+
+// Starts a unary Geyser RPC on `cq` with `tag`, bounded by
+// GEYSER_UNARY_TIMEOUT_MS so a silent server cannot hold up the stream.
+static bool unary_start(geyser_stream_t *stream, grpc_completion_queue *cq, const char *method_name,
+                        const ProtobufCMessage *request, void *tag, geyser_unary_t *unary) {
+    struct geyser_client *client = stream->client;
+    memset(unary, 0, sizeof(*unary));
+    unary->status_code = GRPC_STATUS_UNKNOWN;
+    unary->status_details = grpc_empty_slice();
+    grpc_metadata_array_init(&unary->recv_initial_metadata);
+    grpc_metadata_array_init(&unary->trailing_metadata);
+
+    size_t packed = protobuf_c_message_get_packed_size(request);
+    grpc_slice request_slice = grpc_slice_malloc(packed);
+    protobuf_c_message_pack(request, GRPC_SLICE_START_PTR(request_slice));
+    unary->payload = grpc_raw_byte_buffer_create(&request_slice, 1);
+    grpc_slice_unref(request_slice);
+
+    size_t initial_metadata_count = 0;
+    if (client->config.auth_token[0] != '\0') {
+        unary->auth[0].key = grpc_slice_from_static_string("authorization");
+        unary->auth[0].value = grpc_slice_from_static_string(client->config.auth_token);
+        initial_metadata_count = 1;
+    }
+
+    grpc_slice method = grpc_slice_from_static_string(method_name);
+    grpc_slice host = grpc_slice_from_copied_string(stream->endpoint.authority);
+    gpr_timespec deadline = gpr_time_add(gpr_now(GPR_CLOCK_MONOTONIC),
+                                         gpr_time_from_millis(GEYSER_UNARY_TIMEOUT_MS, GPR_TIMESPAN));
+    unary->call = grpc_channel_create_call(stream->channel, NULL, GRPC_PROPAGATE_DEFAULTS, cq, method, &host,
+                                           deadline, NULL);
+    grpc_slice_unref(host);
+    grpc_slice_unref(method);
+
+    grpc_op ops[6];
+    memset(ops, 0, sizeof(ops));
+    ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+    ops[0].data.send_initial_metadata.count = initial_metadata_count;
+    ops[0].data.send_initial_metadata.metadata = initial_metadata_count ? unary->auth : NULL;
+    ops[1].op = GRPC_OP_SEND_MESSAGE;
+    ops[1].data.send_message.send_message = unary->payload;
+    ops[2].op = GRPC_OP_SEND_CLOSE_FROM_CLIENT;
+    ops[3].op = GRPC_OP_RECV_INITIAL_METADATA;
+    ops[3].data.recv_initial_metadata.recv_initial_metadata = &unary->recv_initial_metadata;
+    ops[4].op = GRPC_OP_RECV_MESSAGE;
+    ops[4].data.recv_message.recv_message = &unary->response;
+    ops[5].op = GRPC_OP_RECV_STATUS_ON_CLIENT;
+    ops[5].data.recv_status_on_client.trailing_metadata = &unary->trailing_metadata;
+    ops[5].data.recv_status_on_client.status = &unary->status_code;
+    ops[5].data.recv_status_on_client.status_details = &unary->status_details;
+    return unary->call && grpc_call_start_batch(unary->call, ops, 6, tag, NULL) == GRPC_CALL_OK;
+}
+
+// Response bytes of a completed unary call (caller unrefs `*response`).
+static bool unary_response(const geyser_unary_t *unary, grpc_slice *response) {
+    if (unary->status_code != GRPC_STATUS_OK || !unary->response)
+        return false;
+    grpc_byte_buffer_reader reader;
+    if (!grpc_byte_buffer_reader_init(&reader, unary->response))
+        return false;
+    *response = grpc_byte_buffer_reader_readall(&reader);
+    grpc_byte_buffer_reader_destroy(&reader);
+    return true;
+}
+
+static void unary_release(geyser_unary_t *unary) {
+    if (unary->response)
+        grpc_byte_buffer_destroy(unary->response);
+    if (unary->payload)
+        grpc_byte_buffer_destroy(unary->payload);
+    grpc_slice_unref(unary->status_details);
+    grpc_metadata_array_destroy(&unary->recv_initial_metadata);
+    grpc_metadata_array_destroy(&unary->trailing_metadata);
+    if (unary->call)
+        grpc_call_unref(unary->call);
+    memset(unary, 0, sizeof(*unary));
+}
+
+// Runs a unary Geyser RPC to completion on a private completion queue, so
+// it never mixes with the Subscribe call's ops.  Cancels when the client
+// stops.
+static bool unary_call(geyser_stream_t *stream, const char *method_name, const ProtobufCMessage *request,
+                       grpc_slice *response) {
+    struct geyser_client *client = stream->client;
     grpc_completion_queue *cq = grpc_completion_queue_create_for_next(NULL);
-    cq_event_cache_t event_cache = {0};
+    geyser_unary_t unary;
+    bool ok = false;
+    if (unary_start(stream, cq, method_name, request, &unary, &unary)) {
+        bool cancelled = false;
+        while (true) {
+            grpc_event ev = cq_next(cq, GEYSER_CQ_POLL_MS);
+            if (ev.type == GRPC_OP_COMPLETE || ev.type == GRPC_QUEUE_SHUTDOWN)
+                break;
+            if (!cancelled && !client->running) {
+                grpc_call_cancel(unary.call, NULL);
+                cancelled = true;
+            }
+        }
+        ok = unary_response(&unary, response);
+        if (unary.status_code != GRPC_STATUS_OK)
+            LOG_DEBUG("%s: %s returned status %d", stream->name, method_name, unary.status_code);
+    }
+    unary_release(&unary);
+    destroy_completion_queue(cq);
+    return ok;
+}
+
+// Fetches the provider's head slot at the stream's commitment (or just
+// pings a provider without GetSlot) for the stall watchdog.
+static void start_probe(geyser_call_state_t *state) {
+    geyser_stream_t *stream = state->stream;
+    bool started;
+    if (stream->probe_with_ping) {
+        Geyser__PingRequest request = GEYSER__PING_REQUEST__INIT;
+        started = unary_start(stream, state->cq, "/geyser.Geyser/Ping", &request.base, &state->probe_op,
+                              &state->probe);
+    } else {
+        Geyser__GetSlotRequest request = GEYSER__GET_SLOT_REQUEST__INIT;
+        request.has_commitment = 1;
+        request.commitment = (Geyser__CommitmentLevel)atomic_load_explicit(&stream->commitment,
+                                                                           memory_order_relaxed);
+        started = unary_start(stream, state->cq, "/geyser.Geyser/GetSlot", &request.base, &state->probe_op,
+                              &state->probe);
+    }
+    if (!started) {
+        unary_release(&state->probe);
+        return;
+    }
+    state->probe_op.pending = true;
+    metrics_inc_watchdog_probe();
+}
+
+// The endpoint's gauge shows its most lagging stream, so one shard falling
+// behind is not hidden by a healthy one that probed last.
+static void publish_behind_head(geyser_stream_t *stream, uint64_t behind) {
+    struct geyser_client *client = stream->client;
+    atomic_store_explicit(&stream->behind_head, behind, memory_order_relaxed);
+    uint64_t worst = 0;
+    for (size_t i = 0; i < client->n_streams; ++i) {
+        const geyser_stream_t *other = &client->streams[i];
+        if (other->endpoint_index != stream->endpoint_index || other->backfill)
+            continue;
+        uint64_t lag = atomic_load_explicit(&other->behind_head, memory_order_relaxed);
+        if (lag > worst)
+            worst = lag;
+    }
+    metrics_set_slots_behind_head(stream->endpoint_index, worst);
+}
+
+// A stream is stalled when it trails the head by more than stall_slots and
+// has not moved since the previous probe; slow catch-up after a resume
+// keeps moving and is left alone.  Without a head slot, stall_slots slot
+// times (400 ms) without progress count as a stall.
+static void on_probe_complete(geyser_call_state_t *state, bool success) {
+    geyser_stream_t *stream = state->stream;
+    const yurei_config_t *config = &stream->client->config;
+    if (!state->call_ok || !stream->client->running) {
+        unary_release(&state->probe);
+        return;
+    }
+    uint64_t now = metrics_now_ns();
+    uint64_t latest = atomic_load_explicit(&stream->latest_slot, memory_order_relaxed);
+    bool progressed = latest != state->probe_last_slot;
+    state->probe_last_slot = latest;
+    if (progressed)
+        state->progress_ns = now;
+
+    bool have_head = false;
+    uint64_t head = 0;
+    grpc_slice response;
+    if (success && unary_response(&state->probe, &response)) {
+        if (!stream->probe_with_ping) {
+            Geyser__GetSlotResponse *reply = geyser__get_slot_response__unpack(
+                NULL, GRPC_SLICE_LENGTH(response), GRPC_SLICE_START_PTR(response));
+            if (reply && reply->has_slot) {
+                have_head = true;
+                head = reply->slot;
+            }
+            if (reply)
+                geyser__get_slot_response__free_unpacked(reply, NULL);
+        }
+        grpc_slice_unref(response);
+    } else {
+        metrics_inc_watchdog_probe_failure();
+        if (!stream->probe_with_ping && state->probe.status_code == GRPC_STATUS_UNIMPLEMENTED) {
+            LOG_WARN("%s: provider has no GetSlot, probing with Ping", stream->name);
+            stream->probe_with_ping = true;
+        }
+    }
+    unary_release(&state->probe);
+
+    bool stalled;
+    if (have_head) {
+        if (state->probe_base_head == 0)
+            state->probe_base_head = head;
+        uint64_t seen = latest ? latest : state->probe_base_head;
+        uint64_t behind = head > seen ? head - seen : 0;
+        publish_behind_head(stream, behind);
+        stalled = behind > config->stall_slots && !progressed;
+        if (stalled)
+            LOG_WARN("%s: stalled %lu slots behind head %lu, reconnecting",
+                     stream->name, (unsigned long)behind, (unsigned long)head);
+    } else {
+        uint64_t idle_ms = (now - state->progress_ns) / 1000000ull;
+        stalled = idle_ms > config->stall_slots * 400ull;
+        if (stalled)
+            LOG_WARN("%s: no slot progress for %lu ms, reconnecting", stream->name, (unsigned long)idle_ms);
+    }
+    if (stalled) {
+        metrics_inc_stall_reconnect();
+        state->call_ok = false;
+    }
+}
+
+// Asks the provider how far back it can replay and clamps the resume slot to
+// it before subscribing.  Slots between the resume point and the first
+// available one cannot be recovered; they are logged and counted rather
+// than found out from a rejected call.  Providers without the RPC keep the
+// old path: the Subscribe status is checked for the rejection instead.
+static void clamp_resume_slot(geyser_stream_t *stream) {
+    if (!stream->from_slot_set)
+        return;
+    Geyser__SubscribeReplayInfoRequest request = GEYSER__SUBSCRIBE_REPLAY_INFO_REQUEST__INIT;
+    grpc_slice response;
+    if (!unary_call(stream, "/geyser.Geyser/SubscribeReplayInfo", &request.base, &response))
+        return;
+    Geyser__SubscribeReplayInfoResponse *info = geyser__subscribe_replay_info_response__unpack(
+        NULL, GRPC_SLICE_LENGTH(response), GRPC_SLICE_START_PTR(response));
+    grpc_slice_unref(response);
+    if (!info)
+        return;
+    if (!info->has_first_available) {
+        LOG_WARN("%s: provider keeps no replay history; resuming at head, gap since slot %lu not recovered",
+                 stream->name, (unsigned long)stream->from_slot);
+        metrics_inc_replay_unavailable();
+        stream->from_slot_set = false;
+        stream->from_slot = 0;
+        stream->replay_rejected = true;
+    } else if (stream->from_slot < info->first_available) {
+        uint64_t gap = info->first_available - stream->from_slot;
+        LOG_WARN("%s: resume slot %lu predates first available slot %lu; %lu slots not recoverable",
+                 stream->name, (unsigned long)stream->from_slot, (unsigned long)info->first_available,
+                 (unsigned long)gap);
+        metrics_record_replay_gap(gap);
+        stream->from_slot = info->first_available;
+    }
+    geyser__subscribe_replay_info_response__free_unpacked(info, NULL);
+}
+
+static bool run_subscription(geyser_stream_t *stream) {
+    struct geyser_client *client = stream->client;
+    refresh_resume_slot(stream);
+    if (!ensure_channel(stream))
+        return false;
+    clamp_resume_slot(stream);
+    if (stream->backfill && (!stream->from_slot_set || stream->from_slot >= stream->backfill_end)) {
+        LOG_ERROR("%s: provider cannot replay slots [%lu, %lu); backfill abandoned", stream->name,
+                  (unsigned long)atomic_load(&stream->backfill_slot), (unsigned long)stream->backfill_end);
+        stream->backfill_failed = true;
+        atomic_store(&stream->backfill_done, true);
+        return false;
+    }
+    if (stream->from_slot_set)
+        LOG_INFO("%s: subscribing from slot %lu", stream->name, (unsigned long)stream->from_slot);
 
     grpc_metadata initial_metadata[1];
     size_t initial_metadata_count = 0;
@@ -308,29 +1772,39 @@ static bool run_subscription(struct geyser_client *client) {
     }
 
     grpc_slice method = grpc_slice_from_static_string("/geyser.Geyser/Subscribe");
-    grpc_slice host = grpc_slice_from_copied_string(client->config.authority);
+    grpc_slice host = grpc_slice_from_copied_string(stream->endpoint.authority);
     gpr_timespec deadline = gpr_inf_future(GPR_CLOCK_REALTIME);
-    grpc_call *call = grpc_channel_create_call(channel, NULL, GRPC_PROPAGATE_DEFAULTS, cq, method, &host, deadline, NULL);
+    grpc_call *call = grpc_channel_create_call(stream->channel, NULL, GRPC_PROPAGATE_DEFAULTS, stream->cq, method,
+                                               &host, deadline, NULL);
     grpc_slice_unref(host);
     grpc_slice_unref(method);
 
-    grpc_byte_buffer *payload = build_subscribe_payload(client);
+    grpc_byte_buffer *payload = build_subscribe_payload(stream, true);
     if (!payload) {
         grpc_call_unref(call);
-        destroy_completion_queue(cq);
-        grpc_channel_destroy(channel);
-        grpc_channel_credentials_release(creds);
         return false;
     }
 
-    grpc_metadata_array recv_initial_metadata;
-    grpc_metadata_array_init(&recv_initial_metadata);
-    grpc_metadata_array trailing_metadata;
-    grpc_metadata_array_init(&trailing_metadata);
-    grpc_status_code status_code = GRPC_STATUS_UNKNOWN;
-    grpc_slice status_details = grpc_empty_slice();
+    geyser_call_state_t state = {
+        .stream = stream,
+        .call = call,
+        .cq = stream->cq,
+        .start_op = {.on_complete = on_start_complete},
+        .status_op = {.on_complete = on_status_complete},
+        .recv_op = {.on_complete = on_recv_complete},
+        .send_op = {.on_complete = on_send_complete},
+        .probe_op = {.on_complete = on_probe_complete},
+        .start_payload = payload,
+        .status_code = GRPC_STATUS_UNKNOWN,
+        .status_details = grpc_empty_slice(),
+        // History is not latency sensitive, so backfill never spins
+        .busy_poll = client->config.busy_poll && !stream->backfill,
+        .call_ok = true,
+    };
+    grpc_metadata_array_init(&state.recv_initial_metadata);
+    grpc_metadata_array_init(&state.trailing_metadata);
 
-    grpc_op ops[4];
+    grpc_op ops[3];
     size_t nops = 0;
 
     ops[nops].op = GRPC_OP_SEND_INITIAL_METADATA;
@@ -347,150 +1821,518 @@ static bool run_subscription(struct geyser_client *client) {
     ops[nops].reserved = NULL;
     nops++;
 
-    ops[nops].op = GRPC_OP_SEND_CLOSE_FROM_CLIENT;
-    ops[nops].flags = 0;
-    ops[nops].reserved = NULL;
-    nops++;
-
     ops[nops].op = GRPC_OP_RECV_INITIAL_METADATA;
-    ops[nops].data.recv_initial_metadata.recv_initial_metadata = &recv_initial_metadata;
+    ops[nops].data.recv_initial_metadata.recv_initial_metadata = &state.recv_initial_metadata;
     ops[nops].flags = 0;
     ops[nops].reserved = NULL;
     nops++;
 
-    grpc_call_error err = grpc_call_start_batch(call, ops, nops, (void *)1, NULL);
-    if (err != GRPC_CALL_OK) {
-        LOG_ERROR("grpc_call_start_batch failed: %d", err);
+    // The request half stays open for keepalive pings; the call ends with
+    // the server's status or a cancel on shutdown.
+    if (!call_start_op(&state, &state.start_op, ops, nops)) {
+        LOG_ERROR("%s: grpc_call_start_batch failed", stream->name);
         grpc_byte_buffer_destroy(payload);
         grpc_call_unref(call);
-        grpc_completion_queue_shutdown(cq);
-        grpc_completion_queue_destroy(cq);
-        grpc_channel_destroy(channel);
-        grpc_channel_credentials_release(creds);
+        grpc_metadata_array_destroy(&state.recv_initial_metadata);
+        grpc_metadata_array_destroy(&state.trailing_metadata);
         return false;
     }
 
     grpc_op status_op;
     status_op.op = GRPC_OP_RECV_STATUS_ON_CLIENT;
-    status_op.data.recv_status_on_client.trailing_metadata = &trailing_metadata;
-    status_op.data.recv_status_on_client.status = &status_code;
-    status_op.data.recv_status_on_client.status_details = &status_details;
+    status_op.data.recv_status_on_client.trailing_metadata = &state.trailing_metadata;
+    status_op.data.recv_status_on_client.status = &state.status_code;
+    status_op.data.recv_status_on_client.status_details = &state.status_details;
     status_op.flags = 0;
     status_op.reserved = NULL;
-    grpc_call_start_batch(call, &status_op, 1, (void *)2, NULL);
+    if (!call_start_op(&state, &state.status_op, &status_op, 1))
+        state.call_ok = false;
 
-    bool handshake_ok = false;
-    grpc_event ev;
-    if (!cq_wait_for_tag(cq, (void *)1, &event_cache, &ev) || !ev.success) {
-        LOG_ERROR("failed to establish subscription");
-        grpc_byte_buffer_destroy(payload);
-        goto cleanup;
-    }
-    handshake_ok = true;
-    grpc_byte_buffer_destroy(payload);
+    uint64_t ping_interval_ns = (uint64_t)client->config.ping_interval_ms * 1000000ull;
+    uint64_t next_ping_ns = metrics_now_ns() + ping_interval_ns;
+    // Backfill trails the head by design, so it is not watched
+    uint64_t watchdog_ns = stream->backfill ? 0 : (uint64_t)client->config.watchdog_interval_ms * 1000000ull;
+    atomic_store(&stream->latest_slot, 0);
+    state.progress_ns = metrics_now_ns();
+    state.next_probe_ns = state.progress_ns + watchdog_ns;
+    atomic_store(&stream->ping_outstanding, 0);
+    atomic_store(&stream->ping_reply_due, false);
 
-    while (client->running) {
-        grpc_byte_buffer *recv_buffer = NULL;
-        grpc_op recv_op;
-        recv_op.op = GRPC_OP_RECV_MESSAGE;
-        recv_op.data.recv_message.recv_message = &recv_buffer;
-        recv_op.flags = 0;
-        recv_op.reserved = NULL;
-        if (grpc_call_start_batch(call, &recv_op, 1, (void *)3, NULL) != GRPC_CALL_OK)
-            break;
-        if (!cq_wait_for_tag(cq, (void *)3, &event_cache, &ev) || !ev.success || recv_buffer == NULL)
+    // Writes start once the first request is through; the loop ends when
+    // the server closes the call, an op fails or the client stops.
+    while (client->running && state.call_ok && state.status_op.pending && !atomic_load(&stream->backfill_done)) {
+        if (state.handshake_ok && !state.send_op.pending) {
+            if (!send_filters_if_changed(&state)) {
+                state.call_ok = false;
+                break;
+            }
+        }
+        if (state.handshake_ok && !state.send_op.pending) {
+            uint64_t now = metrics_now_ns();
+            bool reply_due = atomic_exchange(&stream->ping_reply_due, false);
+            bool timer_due = ping_interval_ns > 0 && now >= next_ping_ns;
+            if (reply_due || timer_due) {
+                if (timer_due && atomic_load(&stream->ping_outstanding) != 0)
+                    LOG_WARN("%s: no pong within %u ms", stream->name, client->config.ping_interval_ms);
+                send_ping(&state);
+                next_ping_ns = now + ping_interval_ns;
+            }
+        }
+        if (watchdog_ns > 0 && state.handshake_ok && !state.probe_op.pending) {
+            uint64_t now = metrics_now_ns();
+            if (now >= state.next_probe_ns) {
+                start_probe(&state);
+                state.next_probe_ns = now + watchdog_ns;
+            }
+        }
+        if (!call_dispatch(&state, GEYSER_CQ_POLL_MS))
             break;
-        grpc_byte_buffer_reader reader;
-        grpc_byte_buffer_reader_init(&reader, recv_buffer);
-        grpc_slice slice = grpc_byte_buffer_reader_readall(&reader);
-        const uint8_t *data = GRPC_SLICE_START_PTR(slice);
-        size_t len = GRPC_SLICE_LENGTH(slice);
-        Geyser__SubscribeUpdate *update = geyser__subscribe_update__unpack(NULL, len, data);
-        grpc_slice_unref(slice);
-        grpc_byte_buffer_reader_destroy(&reader);
-        grpc_byte_buffer_destroy(recv_buffer);
-        if (!update)
-            continue;
-        if (update->update_oneof_case == GEYSER__SUBSCRIBE_UPDATE__UPDATE_ONEOF_TRANSACTION) {
-            handle_transaction(client, update->transaction);
+    }
+
+    // Leaving with the call still open (shutdown, failed handshake or a local
+    // error): cancel so it ends, then run every outstanding op to completion
+    // so the completion queue is clean for the next call.  A stream the
+    // server ended is left to deliver its status, unless we are stopping.
+    bool cancelled = false;
+    if (state.probe_op.pending)
+        grpc_call_cancel(state.probe.call, NULL);
+    while (call_ops_pending(&state)) {
+        if (!cancelled && state.status_op.pending && (!client->running || !state.recv_closed)) {
+            grpc_call_cancel(call, NULL);
+            cancelled = true;
         }
-        geyser__subscribe_update__free_unpacked(update, NULL);
+        if (!call_dispatch(&state, GEYSER_CQ_POLL_MS))
+            break;
     }
+    if (state.start_payload)
+        grpc_byte_buffer_destroy(state.start_payload);
 
-    bool status_received = false;
-    if (cq_wait_for_tag(cq, (void *)2, &event_cache, &ev) && ev.success) {
-        status_received = true;
+    bool handshake_ok = state.handshake_ok;
+    grpc_slice status_details = state.status_details;
+    if (state.status_received) {
         size_t detail_len = GRPC_SLICE_LENGTH(status_details);
         if (detail_len > 0) {
-            LOG_INFO("subscription closed with status %d (%.*s)",
-                     status_code,
+            LOG_INFO("%s: subscription closed with status %d (%.*s)",
+                     stream->name,
+                     state.status_code,
                      (int)detail_len,
                      (const char *)GRPC_SLICE_START_PTR(status_details));
         } else {
-            LOG_INFO("subscription closed with status %d", status_code);
+            LOG_INFO("%s: subscription closed with status %d", stream->name, state.status_code);
         }
     } else {
-        LOG_WARN("subscription ended without status");
+        LOG_WARN("%s: subscription ended without status", stream->name);
     }
 
-    if (status_received && client->config.from_slot_set &&
+    if (state.status_received && stream->from_slot_set &&
         slice_contains_string(status_details, "from_slot is not supported")) {
-        LOG_WARN("endpoint rejected from_slot resume; disabling replay and retrying from head");
-        client->config.from_slot_set = false;
-        client->config.from_slot = 0;
+        LOG_WARN("%s rejected from_slot resume; disabling replay and retrying from head", stream->name);
+        stream->from_slot_set = false;
+        stream->from_slot = 0;
+        stream->replay_rejected = true;
         handshake_ok = false;
     }
 
-cleanup:
     grpc_slice_unref(status_details);
-    grpc_metadata_array_destroy(&recv_initial_metadata);
-    grpc_metadata_array_destroy(&trailing_metadata);
+    grpc_metadata_array_destroy(&state.recv_initial_metadata);
+    grpc_metadata_array_destroy(&state.trailing_metadata);
     grpc_call_unref(call);
-    destroy_completion_queue(cq);
-    grpc_channel_destroy(channel);
-    grpc_channel_credentials_release(creds);
+    // A call that delivered data counts as healthy: reconnect without backoff
+    // and time the gap until the next call's first message.
+    if (!state.received_any)
+        return false;
+    // A finished backfill range is not a disconnect
+    if (stream->ended_ns == 0 && !atomic_load(&stream->backfill_done))
+        stream->ended_ns = metrics_now_ns();
     return handshake_ok;
 }
 
-static void *geyser_thread(void *arg) {
-    struct geyser_client *client = arg;
-    grpc_init();
-    int backoff = 1;
+// Decorrelated jitter: next = min(cap, uniform(base, 3 * previous)).
+// Streams that drop together spread out instead of reconnecting in lockstep.
+static uint32_t next_backoff_ms(geyser_stream_t *stream, uint32_t previous_ms) {
+    uint32_t base = stream->client->config.reconnect_base_ms;
+    uint32_t cap = stream->client->config.reconnect_max_ms;
+    uint64_t upper = (uint64_t)previous_ms * 3;
+    if (upper < base)
+        upper = base;
+    uint64_t span = upper - base + 1;
+    uint64_t next = base + (uint64_t)rand_r(&stream->rng_state) % span;
+    return next > cap ? cap : (uint32_t)next;
+}
+
+static void sleep_while_running(struct geyser_client *client, uint32_t ms) {
+    while (ms > 0 && client->running) {
+        uint32_t step = ms < GEYSER_CQ_POLL_MS ? ms : GEYSER_CQ_POLL_MS;
+        struct timespec ts = {.tv_sec = step / 1000, .tv_nsec = (long)(step % 1000) * 1000000L};
+        nanosleep(&ts, NULL);
+        ms -= step;
+    }
+}
+
+// Keeps the stream's call open until the client stops or, for a backfill
+// stream, its range is done.
+static void run_stream(geyser_stream_t *stream) {
+    struct geyser_client *client = stream->client;
+    uint32_t backoff_ms = 0;
+    while (client->running && !atomic_load(&stream->backfill_done)) {
+        bool ok = run_subscription(stream);
+        if (!client->running || atomic_load(&stream->backfill_done))
+            break;
+        // A stream that was up reconnects at once on the warm channel; only
+        // failed attempts back off.
+        if (ok) {
+            stream->failed_attempts = 0;
+            backoff_ms = 0;
+            continue;
+        }
+        stream->failed_attempts++;
+        backoff_ms = next_backoff_ms(stream, backoff_ms);
+        metrics_inc_reconnect_failure();
+        LOG_INFO("%s: retrying in %u ms", stream->name, backoff_ms);
+        sleep_while_running(client, backoff_ms);
+    }
+}
+
+// Replays each gap the slot tracker hands out with a from_slot resubscribe
+// over just that range.  The channel stays open between repairs.
+static void run_repairs(geyser_stream_t *stream) {
+    struct geyser_client *client = stream->client;
     while (client->running) {
-        bool ok = run_subscription(client);
+        yurei_slot_gap_t gap;
+        if (!slot_tracker_next_gap(client->slot_tracker, &gap)) {
+            sleep_while_running(client, GEYSER_REPAIR_POLL_MS);
+            continue;
+        }
+        LOG_WARN("%s: repairing missing slots [%lu, %lu)", stream->name, (unsigned long)gap.start,
+                 (unsigned long)gap.end);
+        stream->backfill_start = gap.start;
+        stream->backfill_end = gap.end;
+        stream->backfill_failed = false;
+        stream->from_slot = gap.start;
+        stream->from_slot_set = true;
+        stream->replay_rejected = false;
+        atomic_store(&stream->backfill_slot, gap.start);
+        atomic_store(&stream->backfill_done, false);
+        run_stream(stream);
         if (!client->running)
             break;
-        sleep(backoff);
-        if (backoff < 32)
-            backoff *= 2;
-        if (ok)
-            backoff = 1;
+        if (stream->backfill_failed) {
+            metrics_inc_slot_gap_unrecoverable();
+        } else {
+            metrics_inc_slot_gap_repaired();
+            LOG_INFO("%s: slots [%lu, %lu) repaired", stream->name, (unsigned long)gap.start,
+                     (unsigned long)gap.end);
+        }
     }
-    grpc_shutdown();
+}
+
+static void *geyser_stream_thread(void *arg) {
+    geyser_stream_t *stream = arg;
+    stream->rng_state = (unsigned)(metrics_now_ns() ^ (uint64_t)stream->index * 0x9E3779B97F4A7C15ull);
+    if (stream->repair) {
+        run_repairs(stream);
+    } else {
+        run_stream(stream);
+    }
+    if (stream->backfill && !stream->repair && atomic_load(&stream->backfill_done) && !stream->backfill_failed) {
+        uint64_t reached = atomic_load(&stream->backfill_slot);
+        metrics_add_backfill_progress(stream->backfill_end - reached, 0);
+        metrics_inc_backfill_stream_done();
+        LOG_INFO("%s: backfill of slots [%lu, %lu) complete", stream->name,
+                 (unsigned long)stream->backfill_start, (unsigned long)stream->backfill_end);
+    }
+    release_channel(stream);
+    event_batch_free(&stream->inline_batch);
     return NULL;
 }
 
+static void stop_streams(struct geyser_client *client) {
+    client->running = false;
+    for (size_t i = 0; i < client->n_streams; ++i) {
+        if (client->streams[i].started)
+            pthread_join(client->streams[i].thread, NULL);
+        client->streams[i].started = false;
+    }
+    ingest_pipeline_destroy(client->pipeline);
+    client->pipeline = NULL;
+    stream_recorder_destroy(client->recorder);
+    client->recorder = NULL;
+    slot_tracker_destroy(client->slot_tracker);
+    client->slot_tracker = NULL;
+    dedup_set_destroy(client->dedup);
+    client->dedup = NULL;
+    grpc_shutdown();
+
+    geyser_filters_t *filters = atomic_exchange(&client->filters, NULL);
+    while (filters) {
+        geyser_filters_t *retired = filters->retired;
+        free(filters);
+        filters = retired;
+    }
+    pthread_mutex_destroy(&client->filters_lock);
+}
+
 geyser_client_t *geyser_client_start(const yurei_config_t *config,
                                      const yurei_protocol_detector_t *detector,
-                                     yurei_event_queue_t *queue) {
+                                     yurei_event_queue_t *queue,
+                                     yurei_checkpoint_t *checkpoint) {
     struct geyser_client *client = calloc(1, sizeof(*client));
     if (!client)
         return NULL;
     client->config = *config;
-    client->detector = *detector;
-    client->queue = queue;
-    client->running = true;
-    if (pthread_create(&client->thread, NULL, geyser_thread, client) != 0) {
+    geyser_filters_t *filters = calloc(1, sizeof(*filters));
+    if (!filters) {
         free(client);
         return NULL;
     }
+    filters->detector = *detector;
+    filters->commitment = config->commitment;
+    filters->generation = 1;
+    atomic_init(&client->filters, filters);
+    pthread_mutex_init(&client->filters_lock, NULL);
+    client->queue = queue;
+    client->checkpoint = checkpoint;
+    client->running = true;
+    // An explicit GRPC_POLL_STRATEGY in the environment wins
+    if (config->grpc_poll_strategy[0] != '\0')
+        setenv("GRPC_POLL_STRATEGY", config->grpc_poll_strategy, 0);
+    yurei_cpu_list_t own_cpus;
+    bool moved = enter_grpc_cpus(config, &own_cpus);
+    grpc_init();
+    if (moved)
+        topology_bind_thread(pthread_self(), &own_cpus);
+
+    // Shards are the enabled protocols; each gets its own call, CQ and thread
+    // per endpoint.  Without sharding a single stream carries every program.
+    uint32_t shards[8];
+    size_t n_shards = 0;
+    if (config->shard_by_program) {
+        for (int p = YUREI_PROTOCOL_NONE + 1; p < YUREI_PROTOCOL_COUNT; ++p) {
+            if (protocol_detector_has(detector, (yurei_protocol_t)p))
+                shards[n_shards++] = YUREI_PROTOCOL_BIT(p);
+        }
+    }
+    if (n_shards == 0)
+        shards[n_shards++] = YUREI_PROTOCOL_ALL;
+
+    for (size_t key = 0; key < GEYSER_FILTER_COUNT; ++key)
+        metrics_register_filter(key, geyser_filter_keys[key]);
+    for (size_t i = 0; i < config->n_endpoints && client->n_streams < GEYSER_MAX_STREAMS; ++i) {
+        metrics_register_endpoint(i, config->endpoints[i].endpoint);
+        for (size_t s = 0; s < n_shards; ++s) {
+            if (client->n_streams == GEYSER_MAX_STREAMS) {
+                LOG_WARN("stream limit (%d) reached; ignoring remaining endpoint/shard pairs", GEYSER_MAX_STREAMS);
+                break;
+            }
+            geyser_stream_t *stream = &client->streams[client->n_streams];
+            stream->client = client;
+            stream->index = client->n_streams;
+            stream->endpoint_index = i;
+            stream->endpoint = config->endpoints[i];
+            stream->protocols = shards[s];
+            stream->checkpoint_source = (uint8_t)s;
+            // One stream per client carries slot statuses
+            stream->track_slots = config->slot_tracking && client->n_streams == 0;
+            stream->from_slot = config->from_slot;
+            stream->from_slot_set = config->from_slot_set;
+            event_batch_init(&stream->inline_batch);
+            if (shards[s] == YUREI_PROTOCOL_ALL) {
+                snprintf(stream->name, sizeof(stream->name), "%s", stream->endpoint.endpoint);
+            } else {
+                yurei_protocol_t proto = (yurei_protocol_t)__builtin_ctz(shards[s]);
+                snprintf(stream->name, sizeof(stream->name), "%s/%s",
+                         stream->endpoint.endpoint, protocol_detector_name(proto));
+            }
+            client->n_streams++;
+        }
+    }
+
+    // Account streams go to the primary endpoint only: state updates are
+    // keyed by write version, so racing them adds nothing.
+    if (config->account_streams) {
+        yurei_protocol_t account_protocols[2] = {YUREI_PROTOCOL_PUMPFUN, YUREI_PROTOCOL_RAYDIUM};
+        for (size_t p = 0; p < 2 && client->n_streams < GEYSER_MAX_STREAMS; ++p) {
+            if (!protocol_detector_has(detector, account_protocols[p]))
+                continue;
+            geyser_stream_t *stream = &client->streams[client->n_streams];
+            stream->client = client;
+            stream->index = client->n_streams;
+            stream->endpoint_index = 0;
+            stream->endpoint = config->endpoints[0];
+            stream->protocols = YUREI_PROTOCOL_BIT(account_protocols[p]);
+            stream->account_updates = true;
+            stream->checkpoint_source = (uint8_t)(n_shards + p);
+            stream->from_slot = config->from_slot;
+            stream->from_slot_set = config->from_slot_set;
+            event_batch_init(&stream->inline_batch);
+            snprintf(stream->name, sizeof(stream->name), "%s/%s-accounts",
+                     stream->endpoint.endpoint, protocol_detector_name(account_protocols[p]));
+            client->n_streams++;
+        }
+    }
+
+    if (client->n_streams > 1) {
+        client->dedup = dedup_set_create(config->dedup_capacity, config->dedup_slot_window);
+        if (!client->dedup) {
+            LOG_ERROR("failed to allocate dedup set");
+            stop_streams(client);
+            free(client);
+            return NULL;
+        }
+        LOG_INFO("running %zu streams over %zu endpoints (dedup capacity=%zu, window=%lu slots)",
+                 client->n_streams, config->n_endpoints, config->dedup_capacity,
+                 (unsigned long)config->dedup_slot_window);
+    }
+    // Backfill splits [start, end) evenly over its streams on the primary
+    // endpoint.  They are not raced, so they stay out of the dedup set.
+    if (config->backfill_end_slot > config->backfill_start_slot) {
+        uint64_t total = config->backfill_end_slot - config->backfill_start_slot;
+        size_t n_backfill = config->backfill_streams;
+        if (n_backfill > total)
+            n_backfill = (size_t)total;
+        if (n_backfill > GEYSER_MAX_STREAMS - client->n_streams)
+            n_backfill = GEYSER_MAX_STREAMS - client->n_streams;
+        if (n_backfill == 0 || !event_queue_enable_backfill(queue, config->backfill_queue_capacity)) {
+            LOG_ERROR("cannot start backfill (stream limit %d or queue allocation)", GEYSER_MAX_STREAMS);
+            stop_streams(client);
+            free(client);
+            return NULL;
+        }
+        for (size_t b = 0; b < n_backfill; ++b) {
+            geyser_stream_t *stream = &client->streams[client->n_streams];
+            stream->client = client;
+            stream->index = client->n_streams;
+            stream->endpoint_index = 0;
+            stream->endpoint = config->endpoints[0];
+            stream->protocols = YUREI_PROTOCOL_ALL;
+            stream->backfill = true;
+            stream->backfill_start = config->backfill_start_slot + total * b / n_backfill;
+            stream->backfill_end = config->backfill_start_slot + total * (b + 1) / n_backfill;
+            atomic_init(&stream->backfill_slot, stream->backfill_start);
+            stream->from_slot = stream->backfill_start;
+            stream->from_slot_set = true;
+            event_batch_init(&stream->inline_batch);
+            snprintf(stream->name, sizeof(stream->name), "%s/backfill-%lu", stream->endpoint.endpoint,
+                     (unsigned long)stream->backfill_start);
+            client->n_streams++;
+        }
+        metrics_start_backfill(total);
+        LOG_INFO("backfilling slots [%lu, %lu) over %zu streams", (unsigned long)config->backfill_start_slot,
+                 (unsigned long)config->backfill_end_slot, n_backfill);
+    }
+    // Gap detection follows the slot updates of the live streams; a repair
+    // stream on the primary endpoint replays what they missed.
+    if (config->slot_gap_grace_slots > 0) {
+        client->slot_tracker = slot_tracker_create(GEYSER_SLOT_WINDOW, config->slot_gap_grace_slots,
+                                                   GEYSER_MAX_SLOT_GAPS);
+        if (!client->slot_tracker)
+            LOG_WARN("failed to allocate slot tracker; gap detection disabled");
+    }
+    if (client->slot_tracker && config->slot_gap_repair) {
+        if (client->n_streams == GEYSER_MAX_STREAMS ||
+            !event_queue_enable_backfill(queue, config->backfill_queue_capacity)) {
+            LOG_WARN("no room for a repair stream; slot gaps are only reported");
+        } else {
+            geyser_stream_t *stream = &client->streams[client->n_streams];
+            stream->client = client;
+            stream->index = client->n_streams;
+            stream->endpoint_index = 0;
+            stream->endpoint = config->endpoints[0];
+            stream->protocols = YUREI_PROTOCOL_ALL;
+            stream->backfill = true;
+            stream->repair = true;
+            event_batch_init(&stream->inline_batch);
+            snprintf(stream->name, sizeof(stream->name), "%s/repair", stream->endpoint.endpoint);
+            client->n_streams++;
+        }
+    }
+    if (config->capture_dir[0] != '\0') {
+        client->recorder = stream_recorder_create(config->capture_dir, config->capture_segment_bytes,
+                                                  config->capture_buffer_bytes);
+        if (!client->recorder)
+            LOG_WARN("failed to start stream capture to %s", config->capture_dir);
+    }
+    if (config->decode_workers > 0) {
+        client->pipeline = ingest_pipeline_create(config->decode_workers, config->pipeline_depth, queue, decode_message,
+                                                  &config->decode_cpus);
+        if (!client->pipeline)
+            LOG_WARN("failed to start ingest pipeline; decoding on the receive threads");
+    }
+
+    for (size_t i = 0; i < client->n_streams; ++i) {
+        geyser_stream_t *stream = &client->streams[i];
+        if (pthread_create(&stream->thread, NULL, geyser_stream_thread, stream) != 0) {
+            LOG_ERROR("failed to start stream thread for %s", stream->name);
+            stop_streams(client);
+            free(client);
+            return NULL;
+        }
+        stream->started = true;
+        // Live streams (first in the array) get an ingest core each; backfill
+        // and repair streams share the gRPC cores
+        if (stream->backfill)
+            topology_bind_thread(stream->thread, &config->grpc_cpus);
+        else
+            topology_pin_thread(stream->thread, &config->ingest_cpus, i);
+    }
     return client;
 }
 
 void geyser_client_stop(geyser_client_t *client) {
     if (!client)
         return;
-    client->running = false;
-    pthread_join(client->thread, NULL);
+    stop_streams(client);
     free(client);
 }
+
+bool geyser_client_update_filters(geyser_client_t *client,
+                                  const yurei_protocol_detector_t *detector,
+                                  yurei_commitment_t commitment) {
+    if (!client || !detector)
+        return false;
+    if (client->config.shard_by_program) {
+        uint32_t covered = 0;
+        for (size_t i = 0; i < client->n_streams; ++i) {
+            if (!client->streams[i].account_updates && !client->streams[i].backfill)
+                covered |= client->streams[i].protocols;
+        }
+        for (int p = YUREI_PROTOCOL_NONE + 1; p < YUREI_PROTOCOL_COUNT; ++p) {
+            if (protocol_detector_has(detector, (yurei_protocol_t)p) && !(covered & YUREI_PROTOCOL_BIT(p))) {
+                LOG_WARN("enabling a protocol without its own shard requires a restart");
+                return false;
+            }
+        }
+    }
+    geyser_filters_t *next = calloc(1, sizeof(*next));
+    if (!next)
+        return false;
+    next->detector = *detector;
+    next->commitment = commitment;
+
+    pthread_mutex_lock(&client->filters_lock);
+    geyser_filters_t *current = atomic_load(&client->filters);
+    next->generation = current->generation + 1;
+    next->retired = current;
+    atomic_store_explicit(&client->filters, next, memory_order_release);
+    pthread_mutex_unlock(&client->filters_lock);
+
+    LOG_INFO("published filter generation %lu (pumpfun=%s raydium=%s programs=%zu commitment=%s)",
+             (unsigned long)next->generation,
+             protocol_detector_has(detector, YUREI_PROTOCOL_PUMPFUN) ? "on" : "off",
+             protocol_detector_has(detector, YUREI_PROTOCOL_RAYDIUM) ? "on" : "off",
+             detector->n_programs,
+             yurei_commitment_name(commitment));
+    return true;
+}
+
+void geyser_client_get_filters(geyser_client_t *client,
+                               yurei_protocol_detector_t *detector,
+                               yurei_commitment_t *commitment) {
+    if (!client)
+        return;
+    const geyser_filters_t *filters = atomic_load_explicit(&client->filters, memory_order_acquire);
+    if (detector)
+        *detector = filters->detector;
+    if (commitment)
+        *commitment = filters->commitment;
+}
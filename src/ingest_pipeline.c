@@ -0,0 +1,182 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#include "ingest_pipeline.h"
+
+#include "log.h"
+#include "metrics.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef enum {
+    SLOT_FREE = 0,
+    SLOT_PENDING,
+    SLOT_DECODING,
+    SLOT_DONE
+} pipeline_slot_state_t;
+
+typedef struct {
+    pipeline_slot_state_t state;
+    void *message;
+    void *ctx;
+    uint64_t recv_ns;
+    yurei_event_batch_t events;
+} pipeline_slot_t;
+
+// Messages are numbered on submission.  Slot `seq % depth` holds message
+// `seq` from submission until its events have been released, so the window
+// [next_commit, next_submit) is exactly the set of in-flight messages.
+struct yurei_ingest_pipeline {
+    pipeline_slot_t *slots;
+    size_t depth;
+    pthread_t *threads;
+    size_t n_workers;
+    yurei_event_queue_t *queue;
+    yurei_ingest_decode_fn decode;
+
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;
+    pthread_cond_t slot_free;
+    uint64_t next_submit;
+    uint64_t next_claim;
+    uint64_t next_commit;
+    bool committing;
+    bool stopping;
+};
+
+// Releases every decoded message at the head of the window.  Only one worker
+// commits at a time; the lock is dropped while pushing so other workers keep
+// decoding, and the loop re-checks the head so late finishers are picked up.
+static void commit_ready(struct yurei_ingest_pipeline *pipeline) {
+    if (pipeline->committing)
+        return;
+    pipeline->committing = true;
+    while (pipeline->next_commit < pipeline->next_submit) {
+        pipeline_slot_t *slot = &pipeline->slots[pipeline->next_commit % pipeline->depth];
+        if (slot->state != SLOT_DONE)
+            break;
+        pthread_mutex_unlock(&pipeline->lock);
+        if (!event_queue_push_batch(pipeline->queue, slot->events.events, slot->events.count)) {
+            LOG_WARN("dropping %zu events because queue is unavailable", slot->events.count);
+        }
+        event_batch_reset(&slot->events);
+        pthread_mutex_lock(&pipeline->lock);
+        slot->state = SLOT_FREE;
+        pipeline->next_commit++;
+        pthread_cond_signal(&pipeline->slot_free);
+    }
+    pipeline->committing = false;
+}
+
+static void *pipeline_worker(void *arg) {
+    struct yurei_ingest_pipeline *pipeline = arg;
+    pthread_mutex_lock(&pipeline->lock);
+    while (true) {
+        while (!pipeline->stopping && pipeline->next_claim == pipeline->next_submit)
+            pthread_cond_wait(&pipeline->work_ready, &pipeline->lock);
+        if (pipeline->next_claim == pipeline->next_submit)
+            break;
+        pipeline_slot_t *slot = &pipeline->slots[pipeline->next_claim % pipeline->depth];
+        pipeline->next_claim++;
+        slot->state = SLOT_DECODING;
+        pthread_mutex_unlock(&pipeline->lock);
+
+        pipeline->decode(slot->ctx, slot->message, slot->recv_ns, &slot->events);
+        slot->message = NULL;
+
+        pthread_mutex_lock(&pipeline->lock);
+        slot->state = SLOT_DONE;
+        commit_ready(pipeline);
+    }
+    pthread_mutex_unlock(&pipeline->lock);
+    return NULL;
+}
+
+yurei_ingest_pipeline_t *ingest_pipeline_create(size_t workers,
+                                                size_t depth,
+                                                yurei_event_queue_t *queue,
+                                                yurei_ingest_decode_fn decode,
+                                                const yurei_cpu_list_t *cpus) {
+    if (workers == 0 || depth == 0 || !queue || !decode)
+        return NULL;
+    struct yurei_ingest_pipeline *pipeline = calloc(1, sizeof(*pipeline));
+    if (!pipeline)
+        return NULL;
+    pipeline->slots = calloc(depth, sizeof(pipeline_slot_t));
+    pipeline->threads = calloc(workers, sizeof(pthread_t));
+    if (!pipeline->slots || !pipeline->threads) {
+        free(pipeline->slots);
+        free(pipeline->threads);
+        free(pipeline);
+        return NULL;
+    }
+    for (size_t i = 0; i < depth; ++i)
+        event_batch_init(&pipeline->slots[i].events);
+    pipeline->depth = depth;
+    pipeline->queue = queue;
+    pipeline->decode = decode;
+    pthread_mutex_init(&pipeline->lock, NULL);
+    pthread_cond_init(&pipeline->work_ready, NULL);
+    pthread_cond_init(&pipeline->slot_free, NULL);
+
+    for (size_t i = 0; i < workers; ++i) {
+        if (pthread_create(&pipeline->threads[i], NULL, pipeline_worker, pipeline) != 0) {
+            LOG_ERROR("failed to start decode worker %zu", i);
+            break;
+        }
+        topology_pin_thread(pipeline->threads[i], cpus, i);
+        pipeline->n_workers++;
+    }
+    if (pipeline->n_workers == 0) {
+        ingest_pipeline_destroy(pipeline);
+        return NULL;
+    }
+    LOG_INFO("ingest pipeline started (workers=%zu, depth=%zu)", pipeline->n_workers, depth);
+    return pipeline;
+}
+
+bool ingest_pipeline_submit(yurei_ingest_pipeline_t *pipeline, void *message, void *ctx, uint64_t recv_ns) {
+    pthread_mutex_lock(&pipeline->lock);
+    if (!pipeline->stopping && pipeline->next_submit - pipeline->next_commit >= pipeline->depth) {
+        metrics_inc_pipeline_stall();
+        while (!pipeline->stopping && pipeline->next_submit - pipeline->next_commit >= pipeline->depth)
+            pthread_cond_wait(&pipeline->slot_free, &pipeline->lock);
+    }
+    if (pipeline->stopping) {
+        pthread_mutex_unlock(&pipeline->lock);
+        return false;
+    }
+    pipeline_slot_t *slot = &pipeline->slots[pipeline->next_submit % pipeline->depth];
+    slot->message = message;
+    slot->ctx = ctx;
+    slot->recv_ns = recv_ns;
+    slot->state = SLOT_PENDING;
+    pipeline->next_submit++;
+    metrics_update_pipeline_high_water(pipeline->next_submit - pipeline->next_commit);
+    pthread_cond_signal(&pipeline->work_ready);
+    pthread_mutex_unlock(&pipeline->lock);
+    return true;
+}
+
+void ingest_pipeline_destroy(yurei_ingest_pipeline_t *pipeline) {
+    if (!pipeline)
+        return;
+    pthread_mutex_lock(&pipeline->lock);
+    pipeline->stopping = true;
+    pthread_cond_broadcast(&pipeline->work_ready);
+    pthread_cond_broadcast(&pipeline->slot_free);
+    pthread_mutex_unlock(&pipeline->lock);
+    for (size_t i = 0; i < pipeline->n_workers; ++i)
+        pthread_join(pipeline->threads[i], NULL);
+    for (size_t i = 0; i < pipeline->depth; ++i)
+        event_batch_free(&pipeline->slots[i].events);
+    pthread_mutex_destroy(&pipeline->lock);
+    pthread_cond_destroy(&pipeline->work_ready);
+    pthread_cond_destroy(&pipeline->slot_free);
+    free(pipeline->threads);
+    free(pipeline->slots);
+    free(pipeline);
+}
@@ -5,8 +5,12 @@
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
+#include "base58.h"
+#include "checkpoint.h"
+#include "control_socket.h"
 #include "db_writer.h"
 #include "event_queue.h"
 #include "geyser_client.h"
@@ -25,6 +29,89 @@ static void handle_signal(int signo) {
     g_stop = 1;
 }
 
+// "<program id>" replaces the protocol's programs, "off" drops them all.
+static void set_protocol(yurei_protocol_detector_t *detector, yurei_protocol_t protocol, const char *value,
+                         char *reply, size_t reply_len) {
+    if (strcmp(value, "off") == 0) {
+        protocol_detector_remove_protocol(detector, protocol);
+        return;
+    }
+    uint8_t program[32];
+    if (base58_decode(value, program, sizeof(program)) != (int)sizeof(program)) {
+        snprintf(reply, reply_len, "error invalid program id");
+        return;
+    }
+    protocol_detector_remove_protocol(detector, protocol);
+    if (!protocol_detector_add(detector, program, protocol))
+        snprintf(reply, reply_len, "error program registry full");
+}
+
+// Control socket commands:
+//   status
+//   pumpfun <program id|off>
+//   raydium <program id|off>
+//   add <protocol> <program id>
+//   remove <program id>
+//   commitment <processed|confirmed|finalized>
+// Changes are applied to the open streams immediately.
+static void handle_control_command(void *ctx, char *command, char *reply, size_t reply_len) {
+    geyser_client_t *client = ctx;
+    yurei_protocol_detector_t detector;
+    yurei_commitment_t commitment;
+    geyser_client_get_filters(client, &detector, &commitment);
+
+    char *verb = strtok(command, " \t");
+    char *arg = strtok(NULL, " \t");
+    if (!verb) {
+        snprintf(reply, reply_len, "error empty command");
+        return;
+    }
+    if (strcmp(verb, "status") == 0) {
+        snprintf(reply, reply_len, "ok pumpfun=%s raydium=%s programs=%zu commitment=%s",
+                 protocol_detector_has(&detector, YUREI_PROTOCOL_PUMPFUN) ? "on" : "off",
+                 protocol_detector_has(&detector, YUREI_PROTOCOL_RAYDIUM) ? "on" : "off",
+                 detector.n_programs,
+                 yurei_commitment_name(commitment));
+        return;
+    }
+    if (!arg) {
+        snprintf(reply, reply_len, "error missing argument");
+        return;
+    }
+    yurei_protocol_t protocol;
+    uint8_t program[32];
+    if (strcmp(verb, "pumpfun") == 0) {
+        set_protocol(&detector, YUREI_PROTOCOL_PUMPFUN, arg, reply, reply_len);
+    } else if (strcmp(verb, "raydium") == 0) {
+        set_protocol(&detector, YUREI_PROTOCOL_RAYDIUM, arg, reply, reply_len);
+    } else if (strcmp(verb, "add") == 0) {
+        char *id = strtok(NULL, " \t");
+        if (!protocol_detector_parse_name(arg, &protocol))
+            snprintf(reply, reply_len, "error unknown protocol");
+        else if (!id || base58_decode(id, program, sizeof(program)) != (int)sizeof(program))
+            snprintf(reply, reply_len, "error invalid program id");
+        else if (!protocol_detector_add(&detector, program, protocol))
+            snprintf(reply, reply_len, "error program registry full");
+    } else if (strcmp(verb, "remove") == 0) {
+        if (base58_decode(arg, program, sizeof(program)) != (int)sizeof(program))
+            snprintf(reply, reply_len, "error invalid program id");
+        else if (!protocol_detector_remove(&detector, program))
+            snprintf(reply, reply_len, "error program not watched");
+    } else if (strcmp(verb, "commitment") == 0) {
+        if (!yurei_commitment_parse(arg, &commitment))
+            snprintf(reply, reply_len, "error unknown commitment level");
+    } else {
+        snprintf(reply, reply_len, "error unknown command");
+    }
+    if (reply[0] != '\0')
+        return;
+    if (!geyser_client_update_filters(client, &detector, commitment)) {
+        snprintf(reply, reply_len, "error update rejected");
+        return;
+    }
+    snprintf(reply, reply_len, "ok");
+}
+
 int main(void) {
     signal(SIGINT, handle_signal);
     signal(SIGTERM, handle_signal);
@@ -55,16 +142,37 @@ int main(void) {
     }
 
     yurei_protocol_detector_t detector;
-    protocol_detector_init(&detector,
-                           config.pumpfun_program, config.pumpfun_enabled,
-                           config.raydium_program, config.raydium_enabled);
+    protocol_detector_init(&detector);
+    if (config.pumpfun_enabled)
+        protocol_detector_add(&detector, config.pumpfun_program, YUREI_PROTOCOL_PUMPFUN);
+    if (config.raydium_enabled)
+        protocol_detector_add(&detector, config.raydium_program, YUREI_PROTOCOL_RAYDIUM);
+    for (size_t i = 0; i < config.n_extra_programs; ++i) {
+        if (!protocol_detector_add(&detector, config.extra_programs[i].program_id, config.extra_programs[i].protocol))
+            LOG_WARN("program registry full (%d); ignoring the remaining programs", YUREI_DETECTOR_MAX_PROGRAMS);
+    }
 
-    if (config.pumpfun_enabled) LOG_INFO("PumpFun detection: ENABLED");
-    if (config.raydium_enabled) LOG_INFO("Raydium detection: ENABLED");
+    if (protocol_detector_has(&detector, YUREI_PROTOCOL_PUMPFUN)) LOG_INFO("PumpFun detection: ENABLED");
+    if (protocol_detector_has(&detector, YUREI_PROTOCOL_RAYDIUM)) LOG_INFO("Raydium detection: ENABLED");
+    LOG_INFO("Watched programs: %zu", detector.n_programs);
+
+    // Resume point: the later of YUREI_RESUME_FROM_SLOT and the persisted
+    // checkpoint, refreshed by the writer as batches commit.
+    yurei_checkpoint_t checkpoint;
+    checkpoint_init(&checkpoint, 0);
+    bool checkpointing = config.checkpoint_name[0] != '\0';
+    if (checkpointing) {
+        uint64_t slot = 0;
+        if (checkpoint_load(config.db_url, config.checkpoint_name, &slot)) {
+            checkpoint_init(&checkpoint, slot);
+            LOG_INFO("Checkpoint '%s' at slot %lu", config.checkpoint_name, (unsigned long)slot);
+        }
+    }
 
     db_writer_params_t params = {
         .queue = queue,
         .config = &config,
+        .checkpoint = checkpointing ? &checkpoint : NULL,
     };
     db_writer_t *writer = db_writer_start(&params);
     if (!writer) {
@@ -73,7 +181,8 @@ int main(void) {
         return EXIT_FAILURE;
     }
 
-    geyser_client_t *client = geyser_client_start(&config, &detector, queue);
+    geyser_client_t *client = geyser_client_start(&config, &detector, queue,
+                                                  checkpointing ? &checkpoint : NULL);
     if (!client) {
         LOG_ERROR("failed to start geyser client");
         db_writer_stop(writer);
@@ -81,6 +190,13 @@ int main(void) {
         return EXIT_FAILURE;
     }
 
+    control_socket_t *control = NULL;
+    if (config.control_socket[0] != '\0') {
+        control = control_socket_start(config.control_socket, handle_control_command, client);
+        if (!control)
+            LOG_WARN("control socket disabled");
+    }
+
     LOG_INFO("yurei geyser client started - listening for events...");
     
     time_t last_metrics_log = time(NULL);
@@ -96,6 +212,7 @@ int main(void) {
     }
 
     LOG_INFO("shutting down...");
+    control_socket_stop(control);
     geyser_client_stop(client);
     db_writer_stop(writer);
     event_queue_destroy(queue);
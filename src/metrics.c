@@ -2,9 +2,12 @@
 // Copyright 2025 Project Yurei. All rights reserved.
 // https://x.com/yureiai
 
+#define _POSIX_C_SOURCE 200809L  // clock_gettime
+
 #include "metrics.h"
 #include "log.h"
 
+#include <stdio.h>
 #include <string.h>
 
 // Global metrics instance
@@ -15,6 +18,69 @@ void metrics_init(void) {
     clock_gettime(CLOCK_MONOTONIC, &g_metrics.start_time);
 }
 
+uint64_t metrics_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+int64_t metrics_wall_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000ll + (int64_t)ts.tv_nsec;
+}
+
+uint64_t metrics_histogram_percentile(const yurei_histogram_t *h, double percentile) {
+    uint64_t total = atomic_load(&h->count);
+    if (total == 0)
+        return 0;
+    uint64_t target = (uint64_t)((double)total * percentile / 100.0);
+    if (target == 0)
+        target = 1;
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < YUREI_HISTOGRAM_BUCKETS; ++i) {
+        seen += atomic_load(&h->buckets[i]);
+        if (seen >= target)
+            return 2ull << i;
+    }
+    return atomic_load(&h->max_us);
+}
+
+void metrics_register_endpoint(size_t index, const char *name) {
+    if (index >= YUREI_METRICS_MAX_ENDPOINTS || !name)
+        return;
+    snprintf(g_metrics.endpoints[index].name, sizeof(g_metrics.endpoints[index].name), "%s", name);
+    uint64_t count = atomic_load(&g_metrics.n_endpoints);
+    while (index + 1 > count) {
+        if (atomic_compare_exchange_weak(&g_metrics.n_endpoints, &count, index + 1))
+            break;
+    }
+}
+
+void metrics_register_filter(size_t index, const char *name) {
+    if (index >= YUREI_METRICS_MAX_FILTERS || !name)
+        return;
+    snprintf(g_metrics.filters[index].name, sizeof(g_metrics.filters[index].name), "%s", name);
+    uint64_t count = atomic_load(&g_metrics.n_filters);
+    while (index + 1 > count) {
+        if (atomic_compare_exchange_weak(&g_metrics.n_filters, &count, index + 1))
+            break;
+    }
+}
+
+static void log_histogram(const char *label, const yurei_histogram_t *h) {
+    uint64_t count = atomic_load(&h->count);
+    if (count == 0)
+        return;
+    LOG_INFO("  %s: n=%lu avg=%.1fus p50<%luus p99<%luus max=%luus",
+             label,
+             count,
+             (double)atomic_load(&h->sum_us) / (double)count,
+             metrics_histogram_percentile(h, 50.0),
+             metrics_histogram_percentile(h, 99.0),
+             atomic_load(&h->max_us));
+}
+
 double metrics_uptime_seconds(void) {
     struct timespec now;
     clock_gettime(CLOCK_MONOTONIC, &now);
@@ -60,16 +126,123 @@ void metrics_log_summary(void) {
              snap.uptime_seconds, snap.events_per_second);
     LOG_INFO("  Events: total=%lu pumpfun=%lu raydium=%lu dropped=%lu",
              snap.events_total, snap.events_pumpfun, snap.events_raydium, snap.events_dropped);
-    LOG_INFO("  DB: success=%lu failed=%lu batches=%lu reconnects=%lu",
+    LOG_INFO("  Accounts: updates=%lu decode_errors=%lu pumpfun_curves=%lu raydium_pools=%lu",
+             atomic_load(&g_metrics.account_updates),
+             atomic_load(&g_metrics.account_decode_errors),
+             atomic_load(&g_metrics.events_pumpfun_curve),
+             atomic_load(&g_metrics.events_raydium_pool));
+    LOG_INFO("  Blocks: updates=%lu events=%lu",
+             atomic_load(&g_metrics.block_updates),
+             atomic_load(&g_metrics.block_events));
+    LOG_INFO("  DB: success=%lu failed=%lu batches=%lu reconnects=%lu checkpoint_slot=%lu held_below=%lu",
              snap.db_inserts_success, snap.db_inserts_failed,
              atomic_load(&g_metrics.db_batches),
-             atomic_load(&g_metrics.db_reconnects));
+             atomic_load(&g_metrics.db_reconnects),
+             atomic_load(&g_metrics.checkpoint_slot),
+             atomic_load(&g_metrics.checkpoint_held_slot));
+    LOG_INFO("  Slots: confirmed=%lu finalized=%lu dead=%lu",
+             atomic_load(&g_metrics.slots_confirmed),
+             atomic_load(&g_metrics.slots_finalized),
+             atomic_load(&g_metrics.slots_dead));
     LOG_INFO("  Queue: pushes=%lu pops=%lu high_water=%lu overflows=%lu",
              atomic_load(&g_metrics.queue_pushes),
              atomic_load(&g_metrics.queue_pops),
              snap.queue_high_water,
              atomic_load(&g_metrics.queue_overflows));
+    LOG_INFO("  Pipeline: high_water=%lu stalls=%lu",
+             atomic_load(&g_metrics.pipeline_high_water),
+             atomic_load(&g_metrics.pipeline_stalls));
+    LOG_INFO("  Arena: high_water=%lu reserved=%lu bytes",
+             atomic_load(&g_metrics.arena_high_water),
+             atomic_load(&g_metrics.arena_reserved));
+    LOG_INFO("  Recv: single_slice=%lu multi_slice=%lu copied_bytes=%lu",
+             atomic_load(&g_metrics.recv_single_slice),
+             atomic_load(&g_metrics.recv_multi_slice),
+             atomic_load(&g_metrics.recv_copied_bytes));
+    LOG_INFO("  Wire: bytes=%lu decoded_bytes=%lu compressed_msgs=%lu",
+             atomic_load(&g_metrics.recv_wire_bytes),
+             atomic_load(&g_metrics.recv_decoded_bytes),
+             atomic_load(&g_metrics.recv_compressed));
+    if (atomic_load(&g_metrics.capture_segments) > 0) {
+        LOG_INFO("  Capture: records=%lu bytes=%lu dropped=%lu segments=%lu",
+                 atomic_load(&g_metrics.capture_records),
+                 atomic_load(&g_metrics.capture_bytes),
+                 atomic_load(&g_metrics.capture_dropped),
+                 atomic_load(&g_metrics.capture_segments));
+    }
+    LOG_INFO("  Decoder: scanner_fallbacks=%lu mismatches=%lu",
+             atomic_load(&g_metrics.scanner_fallbacks),
+             atomic_load(&g_metrics.decoder_mismatches));
+    LOG_INFO("  Keepalive: pings=%lu pongs=%lu server_pings=%lu",
+             atomic_load(&g_metrics.pings_sent),
+             atomic_load(&g_metrics.pongs_received),
+             atomic_load(&g_metrics.server_pings));
+    log_histogram("Ping RTT", &g_metrics.ping_rtt_us);
+    LOG_INFO("  Reconnects: done=%lu failed_attempts=%lu",
+             atomic_load(&g_metrics.reconnect_us.count),
+             atomic_load(&g_metrics.reconnect_failures));
+    log_histogram("Reconnect time", &g_metrics.reconnect_us);
+    LOG_INFO("  Replay: gaps=%lu lost_slots=%lu unavailable=%lu",
+             atomic_load(&g_metrics.replay_gaps),
+             atomic_load(&g_metrics.replay_gap_slots),
+             atomic_load(&g_metrics.replay_unavailable));
+    uint64_t slots_behind = 0;
+    for (uint64_t i = 0; i < atomic_load(&g_metrics.n_endpoints) && i < YUREI_METRICS_MAX_ENDPOINTS; ++i) {
+        uint64_t behind = atomic_load(&g_metrics.endpoints[i].slots_behind_head);
+        if (behind > slots_behind)
+            slots_behind = behind;
+    }
+    LOG_INFO("  Watchdog: probes=%lu probe_failures=%lu stall_reconnects=%lu slots_behind_head=%lu",
+             atomic_load(&g_metrics.watchdog_probes),
+             atomic_load(&g_metrics.watchdog_probe_failures),
+             atomic_load(&g_metrics.stall_reconnects),
+             slots_behind);
+    LOG_INFO("  Slot gaps: found=%lu missing_slots=%lu repaired=%lu unrecoverable=%lu",
+             atomic_load(&g_metrics.slot_gaps),
+             atomic_load(&g_metrics.slot_gap_slots),
+             atomic_load(&g_metrics.slot_gaps_repaired),
+             atomic_load(&g_metrics.slot_gaps_unrecoverable));
+    uint64_t backfill_total = atomic_load(&g_metrics.backfill_slots_total);
+    if (backfill_total > 0) {
+        uint64_t done = atomic_load(&g_metrics.backfill_slots_done);
+        double elapsed_s = (double)(metrics_now_ns() - atomic_load(&g_metrics.backfill_started_ns)) / 1e9;
+        double rate = elapsed_s > 0 ? (double)done / elapsed_s : 0.0;
+        uint64_t left = done < backfill_total ? backfill_total - done : 0;
+        LOG_INFO("  Backfill: slots=%lu/%lu (%.1f%%) rate=%.1f slots/s eta=%.0fs events=%lu streams_done=%lu",
+                 done, backfill_total, 100.0 * (double)done / (double)backfill_total, rate,
+                 rate > 0 ? (double)left / rate : 0.0,
+                 atomic_load(&g_metrics.backfill_events),
+                 atomic_load(&g_metrics.backfill_streams_done));
+    }
+    uint64_t n_endpoints = atomic_load(&g_metrics.n_endpoints);
+    if (n_endpoints > 1) {
+        for (uint64_t i = 0; i < n_endpoints && i < YUREI_METRICS_MAX_ENDPOINTS; ++i) {
+            const yurei_endpoint_metrics_t *ep = &g_metrics.endpoints[i];
+            char label[YUREI_METRICS_ENDPOINT_NAME + 32];
+            LOG_INFO("  Endpoint %s: won=%lu duplicates=%lu slots_behind_head=%lu",
+                     ep->name,
+                     atomic_load(&ep->races_won),
+                     atomic_load(&ep->duplicates),
+                     atomic_load(&ep->slots_behind_head));
+            snprintf(label, sizeof(label), "Endpoint %s lag", ep->name);
+            log_histogram(label, &ep->arrival_lag_us);
+        }
+        LOG_INFO("  Dedup: evictions=%lu", atomic_load(&g_metrics.dedup_evictions));
+    }
+    uint64_t n_filters = atomic_load(&g_metrics.n_filters);
+    for (uint64_t i = 0; i < n_filters && i < YUREI_METRICS_MAX_FILTERS; ++i) {
+        const yurei_filter_metrics_t *filter = &g_metrics.filters[i];
+        LOG_INFO("  Filter %s: updates=%lu bytes=%lu",
+                 filter->name,
+                 atomic_load(&filter->updates),
+                 atomic_load(&filter->bytes));
+    }
     LOG_INFO("  Latency: event_avg=%.2fus db_avg=%.2fus",
              snap.avg_event_latency_us, snap.avg_db_latency_us);
+    log_histogram("Provider -> receive", &g_metrics.provider_recv_us);
+    log_histogram("Receive -> enqueue", &g_metrics.recv_enqueue_us);
+    log_histogram("Enqueue -> dequeue", &g_metrics.queue_wait_us);
+    log_histogram("Dequeue -> commit", &g_metrics.dequeue_commit_us);
+    log_histogram("Provider -> commit", &g_metrics.provider_commit_us);
     LOG_INFO("=====================");
 }
@@ -0,0 +1,144 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#include "pb_arena.h"
+
+#include "metrics.h"
+
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define PB_ARENA_DEFAULT_CHUNK (64 * 1024)
+#define PB_ARENA_ALIGN alignof(max_align_t)
+
+struct yurei_pb_arena_chunk {
+    yurei_pb_arena_chunk_t *next;
+    size_t size;
+    size_t used;
+    alignas(max_align_t) uint8_t data[];
+};
+
+static yurei_pb_arena_chunk_t *chunk_create(size_t size) {
+    yurei_pb_arena_chunk_t *chunk = malloc(sizeof(*chunk) + size);
+    if (!chunk)
+        return NULL;
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    return chunk;
+}
+
+static void *arena_alloc_cb(void *allocator_data, size_t size) {
+    return pb_arena_alloc(allocator_data, size);
+}
+
+static void arena_free_cb(void *allocator_data, void *pointer) {
+    (void)allocator_data;
+    (void)pointer;
+}
+
+bool pb_arena_init(yurei_pb_arena_t *arena, size_t chunk_size) {
+    if (!arena)
+        return false;
+    if (chunk_size == 0)
+        chunk_size = PB_ARENA_DEFAULT_CHUNK;
+    arena->head = chunk_create(chunk_size);
+    if (!arena->head)
+        return false;
+    arena->current = arena->head;
+    arena->chunk_size = chunk_size;
+    arena->used = 0;
+    arena->reserved = chunk_size;
+    arena->high_water = 0;
+    arena->allocator.alloc = arena_alloc_cb;
+    arena->allocator.free = arena_free_cb;
+    arena->allocator.allocator_data = arena;
+    return true;
+}
+
+void *pb_arena_alloc(yurei_pb_arena_t *arena, size_t size) {
+    size = (size + PB_ARENA_ALIGN - 1) & ~(size_t)(PB_ARENA_ALIGN - 1);
+    if (size == 0)
+        size = PB_ARENA_ALIGN;
+    yurei_pb_arena_chunk_t *chunk = arena->current;
+    if (chunk->size - chunk->used < size) {
+        // Chunks after `current` are leftovers from an earlier, larger update
+        // and are considered empty until the cursor reaches them again.
+        yurei_pb_arena_chunk_t *next = chunk->next;
+        if (next && next->size >= size) {
+            next->used = 0;
+        } else {
+            size_t want = arena->chunk_size;
+            while (want < size)
+                want *= 2;
+            yurei_pb_arena_chunk_t *fresh = chunk_create(want);
+            if (!fresh)
+                return NULL;
+            fresh->next = next;
+            chunk->next = fresh;
+            arena->reserved += want;
+            next = fresh;
+        }
+        arena->current = next;
+        chunk = next;
+    }
+    void *ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    arena->used += size;
+    return ptr;
+}
+
+void pb_arena_reset(yurei_pb_arena_t *arena) {
+    if (arena->used > arena->high_water) {
+        arena->high_water = arena->used;
+        metrics_update_arena_high_water(arena->used, arena->reserved);
+    }
+    arena->used = 0;
+    arena->current = arena->head;
+    arena->head->used = 0;
+}
+
+void pb_arena_destroy(yurei_pb_arena_t *arena) {
+    if (!arena)
+        return;
+    yurei_pb_arena_chunk_t *chunk = arena->head;
+    while (chunk) {
+        yurei_pb_arena_chunk_t *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->head = NULL;
+    arena->current = NULL;
+}
+
+static pthread_key_t g_arena_key;
+static pthread_once_t g_arena_once = PTHREAD_ONCE_INIT;
+
+static void thread_arena_release(void *ptr) {
+    yurei_pb_arena_t *arena = ptr;
+    pb_arena_destroy(arena);
+    free(arena);
+}
+
+static void thread_arena_key_init(void) {
+    pthread_key_create(&g_arena_key, thread_arena_release);
+}
+
+yurei_pb_arena_t *pb_arena_thread_local(void) {
+    pthread_once(&g_arena_once, thread_arena_key_init);
+    yurei_pb_arena_t *arena = pthread_getspecific(g_arena_key);
+    if (arena)
+        return arena;
+    arena = malloc(sizeof(*arena));
+    if (!arena)
+        return NULL;
+    if (!pb_arena_init(arena, PB_ARENA_DEFAULT_CHUNK)) {
+        free(arena);
+        return NULL;
+    }
+    pthread_setspecific(g_arena_key, arena);
+    return arena;
+}
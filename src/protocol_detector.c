@@ -12,88 +12,220 @@
 
 static const size_t PROGRAM_ID_LEN = 32;
 
+// slot_program stores index + 1 in a byte.
+_Static_assert(YUREI_DETECTOR_MAX_PROGRAMS < 256, "too many programs for slot_program");
+
+// Candidate positions are those where both the first and the last needle
+// byte match, checked for a whole vector of start offsets at once; the
+// offsets the vector loop cannot load are finished byte by byte.
 static const uint8_t *fast_memmem(const uint8_t *haystack, size_t haystack_len, const uint8_t *needle, size_t needle_len) {
     if (needle_len == 0 || haystack_len < needle_len)
         return NULL;
+    size_t i = 0;
+    size_t last = needle_len - 1;
 #if defined(__AVX2__)
-    __m256i needle_vec = _mm256_loadu_si256((const __m256i *)needle);
-    for (size_t i = 0; i + needle_len <= haystack_len; i += 32) {
-        __m256i chunk = _mm256_loadu_si256((const __m256i *)(haystack + i));
-        __m256i cmp = _mm256_cmpeq_epi8(chunk, needle_vec);
-        int mask = _mm256_movemask_epi8(cmp);
-        if (mask == -1) {
-            if (memcmp(haystack + i, needle, needle_len) == 0)
-                return haystack + i;
-        } else if (mask) {
-            while (mask) {
-                int bit = __builtin_ctz(mask);
-                mask &= mask - 1;
-                size_t pos = i + (size_t)bit;
-                if (pos + needle_len <= haystack_len && memcmp(haystack + pos, needle, needle_len) == 0)
-                    return haystack + pos;
-            }
+    __m256i first_vec = _mm256_set1_epi8((char)needle[0]);
+    __m256i last_vec = _mm256_set1_epi8((char)needle[last]);
+    for (; i + last + 32 <= haystack_len; i += 32) {
+        __m256i block_first = _mm256_loadu_si256((const __m256i *)(haystack + i));
+        __m256i block_last = _mm256_loadu_si256((const __m256i *)(haystack + i + last));
+        __m256i both = _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first_vec),
+                                        _mm256_cmpeq_epi8(block_last, last_vec));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(both);
+        while (mask) {
+            size_t pos = i + (size_t)__builtin_ctz(mask);
+            mask &= mask - 1;
+            if (memcmp(haystack + pos, needle, needle_len) == 0)
+                return haystack + pos;
         }
     }
 #elif defined(__SSE2__)
-    __m128i first = _mm_loadu_si128((const __m128i *)needle);
-    for (size_t i = 0; i + needle_len <= haystack_len; i += 16) {
-        __m128i chunk = _mm_loadu_si128((const __m128i *)(haystack + i));
-        __m128i cmp = _mm_cmpeq_epi8(chunk, first);
-        int mask = _mm_movemask_epi8(cmp);
+    __m128i first_vec = _mm_set1_epi8((char)needle[0]);
+    __m128i last_vec = _mm_set1_epi8((char)needle[last]);
+    for (; i + last + 16 <= haystack_len; i += 16) {
+        __m128i block_first = _mm_loadu_si128((const __m128i *)(haystack + i));
+        __m128i block_last = _mm_loadu_si128((const __m128i *)(haystack + i + last));
+        __m128i both = _mm_and_si128(_mm_cmpeq_epi8(block_first, first_vec), _mm_cmpeq_epi8(block_last, last_vec));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(both);
         while (mask) {
-            int bit = __builtin_ctz(mask);
+            size_t pos = i + (size_t)__builtin_ctz(mask);
             mask &= mask - 1;
-            size_t pos = i + (size_t)bit;
-            if (pos + needle_len <= haystack_len && memcmp(haystack + pos, needle, needle_len) == 0)
+            if (memcmp(haystack + pos, needle, needle_len) == 0)
                 return haystack + pos;
         }
     }
-#else
-    for (size_t i = 0; i + needle_len <= haystack_len; ++i) {
-        if (memcmp(haystack + i, needle, needle_len) == 0)
+#endif
+    for (; i + needle_len <= haystack_len; ++i) {
+        if (haystack[i] == needle[0] && haystack[i + last] == needle[last] &&
+            memcmp(haystack + i, needle, needle_len) == 0)
             return haystack + i;
     }
-#endif
     return NULL;
 }
 
-void protocol_detector_init(yurei_protocol_detector_t *detector,
-                            const uint8_t pumpfun_program[32], bool pumpfun_enabled,
-                            const uint8_t raydium_program[32], bool raydium_enabled) {
+static inline uint64_t key_prefix(const uint8_t *key) {
+    uint64_t prefix;
+    memcpy(&prefix, key, sizeof(prefix));
+    return prefix;
+}
+
+// Program ids are hashes already, but a multiply keeps crafted or
+// sequential prefixes from piling into one probe chain.
+static inline size_t prefix_slot(uint64_t prefix) {
+    return (size_t)((prefix * 0x9E3779B97F4A7C15ull) >> (64 - YUREI_DETECTOR_TABLE_BITS));
+}
+
+// Index of the program with this key, or -1.
+static inline int find_program(const yurei_protocol_detector_t *detector, const uint8_t *key) {
+    uint64_t prefix = key_prefix(key);
+    size_t slot = prefix_slot(prefix);
+    while (detector->slot_program[slot]) {
+        if (detector->slot_prefix[slot] == prefix) {
+            int index = detector->slot_program[slot] - 1;
+            if (memcmp(detector->programs[index].program_id, key, PROGRAM_ID_LEN) == 0)
+                return index;
+        }
+        slot = (slot + 1) & (YUREI_DETECTOR_TABLE_SIZE - 1);
+    }
+    return -1;
+}
+
+static void rebuild_table(yurei_protocol_detector_t *detector) {
+    memset(detector->slot_prefix, 0, sizeof(detector->slot_prefix));
+    memset(detector->slot_program, 0, sizeof(detector->slot_program));
+    for (size_t i = 0; i < detector->n_programs; ++i) {
+        uint64_t prefix = key_prefix(detector->programs[i].program_id);
+        size_t slot = prefix_slot(prefix);
+        while (detector->slot_program[slot])
+            slot = (slot + 1) & (YUREI_DETECTOR_TABLE_SIZE - 1);
+        detector->slot_prefix[slot] = prefix;
+        detector->slot_program[slot] = (uint8_t)(i + 1);
+    }
+}
+
+void protocol_detector_init(yurei_protocol_detector_t *detector) {
     memset(detector, 0, sizeof(*detector));
-    if (pumpfun_enabled) {
-        memcpy(detector->pumpfun.program_id, pumpfun_program, PROGRAM_ID_LEN);
-        detector->pumpfun.enabled = true;
+}
+
+bool protocol_detector_add(yurei_protocol_detector_t *detector,
+                           const uint8_t program_id[32],
+                           yurei_protocol_t protocol) {
+    if (protocol <= YUREI_PROTOCOL_NONE || protocol >= YUREI_PROTOCOL_COUNT)
+        return false;
+    int existing = find_program(detector, program_id);
+    if (existing >= 0) {
+        detector->programs[existing].protocol = protocol;
+        return true;
     }
-    if (raydium_enabled) {
-        memcpy(detector->raydium.program_id, raydium_program, PROGRAM_ID_LEN);
-        detector->raydium.enabled = true;
+    if (detector->n_programs == YUREI_DETECTOR_MAX_PROGRAMS)
+        return false;
+    yurei_protocol_program_t *program = &detector->programs[detector->n_programs++];
+    memcpy(program->program_id, program_id, PROGRAM_ID_LEN);
+    program->protocol = protocol;
+    // Linear probing cannot delete in place, but appending only needs the
+    // new slot.
+    uint64_t prefix = key_prefix(program_id);
+    size_t slot = prefix_slot(prefix);
+    while (detector->slot_program[slot])
+        slot = (slot + 1) & (YUREI_DETECTOR_TABLE_SIZE - 1);
+    detector->slot_prefix[slot] = prefix;
+    detector->slot_program[slot] = (uint8_t)detector->n_programs;
+    return true;
+}
+
+bool protocol_detector_remove(yurei_protocol_detector_t *detector, const uint8_t program_id[32]) {
+    int index = find_program(detector, program_id);
+    if (index < 0)
+        return false;
+    memmove(&detector->programs[index], &detector->programs[index + 1],
+            (detector->n_programs - (size_t)index - 1) * sizeof(detector->programs[0]));
+    detector->n_programs--;
+    rebuild_table(detector);
+    return true;
+}
+
+size_t protocol_detector_remove_protocol(yurei_protocol_detector_t *detector, yurei_protocol_t protocol) {
+    size_t kept = 0;
+    for (size_t i = 0; i < detector->n_programs; ++i) {
+        if (detector->programs[i].protocol != protocol)
+            detector->programs[kept++] = detector->programs[i];
     }
+    size_t removed = detector->n_programs - kept;
+    detector->n_programs = kept;
+    if (removed)
+        rebuild_table(detector);
+    return removed;
+}
+
+yurei_protocol_t protocol_detector_lookup(const yurei_protocol_detector_t *detector, const uint8_t key[32]) {
+    int index = find_program(detector, key);
+    return index < 0 ? YUREI_PROTOCOL_NONE : detector->programs[index].protocol;
 }
 
-bool protocol_detector_match_program(const yurei_protocol_pattern_t *pattern,
+bool protocol_detector_has(const yurei_protocol_detector_t *detector, yurei_protocol_t protocol) {
+    for (size_t i = 0; i < detector->n_programs; ++i) {
+        if (detector->programs[i].protocol == protocol)
+            return true;
+    }
+    return false;
+}
+
+size_t protocol_detector_programs(const yurei_protocol_detector_t *detector,
+                                  yurei_protocol_t protocol,
+                                  const uint8_t **out,
+                                  size_t max) {
+    size_t n = 0;
+    for (size_t i = 0; i < detector->n_programs && n < max; ++i) {
+        if (detector->programs[i].protocol == protocol)
+            out[n++] = detector->programs[i].program_id;
+    }
+    return n;
+}
+
+const char *protocol_detector_name(yurei_protocol_t protocol) {
+    switch (protocol) {
+    case YUREI_PROTOCOL_PUMPFUN:
+        return "pumpfun";
+    case YUREI_PROTOCOL_RAYDIUM:
+        return "raydium";
+    case YUREI_PROTOCOL_NONE:
+    default:
+        return "none";
+    }
+}
+
+bool protocol_detector_parse_name(const char *name, yurei_protocol_t *out) {
+    for (int p = YUREI_PROTOCOL_NONE + 1; p < YUREI_PROTOCOL_COUNT; ++p) {
+        if (strcmp(name, protocol_detector_name((yurei_protocol_t)p)) == 0) {
+            *out = (yurei_protocol_t)p;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool protocol_detector_match_program(const yurei_protocol_program_t *program,
                                      const uint8_t *data,
                                      size_t len) {
-    if (!pattern->enabled || !data)
+    if (!program || !data)
         return false;
-    return fast_memmem(data, len, pattern->program_id, PROGRAM_ID_LEN) != NULL;
+    return fast_memmem(data, len, program->program_id, PROGRAM_ID_LEN) != NULL;
 }
 
+// One table probe per key, however many programs are watched;
+// bench_protocol_detector compares it with per-program vector compares.
 yurei_protocol_t protocol_detector_match_accounts(const yurei_protocol_detector_t *detector,
                                                   const uint8_t *const *accounts,
                                                   const size_t *account_lens,
                                                   size_t n_accounts) {
+    if (detector->n_programs == 0)
+        return YUREI_PROTOCOL_NONE;
     for (size_t i = 0; i < n_accounts; ++i) {
-        if (!accounts[i] || account_lens[i] == 0)
+        if (!accounts[i] || account_lens[i] != PROGRAM_ID_LEN)
             continue;
-        if (detector->pumpfun.enabled && account_lens[i] == PROGRAM_ID_LEN &&
-            memcmp(accounts[i], detector->pumpfun.program_id, PROGRAM_ID_LEN) == 0) {
-            return YUREI_PROTOCOL_PUMPFUN;
-        }
-        if (detector->raydium.enabled && account_lens[i] == PROGRAM_ID_LEN &&
-            memcmp(accounts[i], detector->raydium.program_id, PROGRAM_ID_LEN) == 0) {
-            return YUREI_PROTOCOL_RAYDIUM;
-        }
+        int index = find_program(detector, accounts[i]);
+        if (index >= 0)
+            return detector->programs[index].protocol;
     }
     return YUREI_PROTOCOL_NONE;
 }
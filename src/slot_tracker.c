@@ -0,0 +1,170 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#include "slot_tracker.h"
+
+#include "log.h"
+#include "metrics.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+// Bit `slot & mask` covers a slot in [cursor, cursor + window).  Everything
+// below `cursor` has been judged and its bit cleared for reuse; `highest`
+// stays inside the ring so no live bit is ever overwritten.
+struct yurei_slot_tracker {
+    pthread_mutex_t lock;
+    uint64_t *bits;
+    uint64_t mask;
+    uint64_t grace;
+    bool started;
+    uint64_t cursor;
+    uint64_t highest;
+    yurei_slot_gap_t *gaps;
+    size_t max_gaps;
+    size_t gap_head;
+    size_t gap_count;
+};
+
+static uint64_t round_up_pow2(uint64_t v) {
+    uint64_t p = 64;
+    while (p < v)
+        p <<= 1;
+    return p;
+}
+
+static bool test_and_clear(struct yurei_slot_tracker *tracker, uint64_t slot) {
+    uint64_t bit = slot & tracker->mask;
+    uint64_t *word = &tracker->bits[bit / 64];
+    uint64_t flag = 1ull << (bit % 64);
+    bool set = (*word & flag) != 0;
+    *word &= ~flag;
+    return set;
+}
+
+static void set_bit(struct yurei_slot_tracker *tracker, uint64_t slot) {
+    uint64_t bit = slot & tracker->mask;
+    tracker->bits[bit / 64] |= 1ull << (bit % 64);
+}
+
+// Queues [start, end), extending the newest queued gap when it ends where
+// this one starts.  With the queue full the gap cannot be repaired.
+static void queue_gap(struct yurei_slot_tracker *tracker, uint64_t start, uint64_t end) {
+    if (tracker->gap_count > 0) {
+        yurei_slot_gap_t *last = &tracker->gaps[(tracker->gap_head + tracker->gap_count - 1) % tracker->max_gaps];
+        if (last->end == start) {
+            last->end = end;
+            metrics_record_slot_gap(0, end - start);
+            return;
+        }
+    }
+    metrics_record_slot_gap(1, end - start);
+    LOG_WARN("slots missing from %lu", (unsigned long)start);
+    if (tracker->gap_count == tracker->max_gaps) {
+        LOG_ERROR("slot repair queue full; gap [%lu, %lu) not repaired", (unsigned long)start, (unsigned long)end);
+        metrics_inc_slot_gap_unrecoverable();
+        return;
+    }
+    tracker->gaps[(tracker->gap_head + tracker->gap_count) % tracker->max_gaps] = (yurei_slot_gap_t){start, end};
+    tracker->gap_count++;
+}
+
+// Judges every slot in [cursor, to).  Bits above `highest` were never set,
+// so that part is a single gap without scanning it.
+static void sweep(struct yurei_slot_tracker *tracker, uint64_t to) {
+    uint64_t scan_end = to < tracker->highest + 1 ? to : tracker->highest + 1;
+    uint64_t gap_start = 0;
+    bool in_gap = false;
+    for (uint64_t slot = tracker->cursor; slot < scan_end; ++slot) {
+        bool seen = test_and_clear(tracker, slot);
+        if (!seen && !in_gap) {
+            gap_start = slot;
+            in_gap = true;
+        } else if (seen && in_gap) {
+            queue_gap(tracker, gap_start, slot);
+            in_gap = false;
+        }
+    }
+    if (scan_end < to) {
+        if (!in_gap)
+            gap_start = scan_end > tracker->cursor ? scan_end : tracker->cursor;
+        in_gap = true;
+    }
+    if (in_gap)
+        queue_gap(tracker, gap_start, to);
+    if (to > tracker->cursor)
+        tracker->cursor = to;
+}
+
+yurei_slot_tracker_t *slot_tracker_create(size_t window, uint64_t grace_slots, size_t max_gaps) {
+    if (max_gaps == 0)
+        return NULL;
+    struct yurei_slot_tracker *tracker = calloc(1, sizeof(*tracker));
+    if (!tracker)
+        return NULL;
+    uint64_t slots = round_up_pow2(window > 2 * grace_slots ? window : 2 * grace_slots);
+    tracker->bits = calloc(slots / 64, sizeof(uint64_t));
+    tracker->gaps = calloc(max_gaps, sizeof(yurei_slot_gap_t));
+    if (!tracker->bits || !tracker->gaps) {
+        free(tracker->bits);
+        free(tracker->gaps);
+        free(tracker);
+        return NULL;
+    }
+    tracker->mask = slots - 1;
+    tracker->grace = grace_slots;
+    tracker->max_gaps = max_gaps;
+    pthread_mutex_init(&tracker->lock, NULL);
+    return tracker;
+}
+
+void slot_tracker_destroy(yurei_slot_tracker_t *tracker) {
+    if (!tracker)
+        return;
+    pthread_mutex_destroy(&tracker->lock);
+    free(tracker->bits);
+    free(tracker->gaps);
+    free(tracker);
+}
+
+void slot_tracker_observe(yurei_slot_tracker_t *tracker, uint64_t slot, uint64_t parent) {
+    pthread_mutex_lock(&tracker->lock);
+    if (!tracker->started) {
+        tracker->started = true;
+        tracker->cursor = slot;
+        tracker->highest = slot;
+    }
+    if (slot < tracker->cursor) {
+        pthread_mutex_unlock(&tracker->lock);
+        return;
+    }
+    // Make room: slots that would fall out of the ring are judged now
+    if (slot > tracker->mask && slot - tracker->mask > tracker->cursor)
+        sweep(tracker, slot - tracker->mask);
+    // A parent link spanning more than the ring is not trusted
+    uint64_t first = slot;
+    if (parent != 0 && parent < slot && slot - parent <= tracker->mask)
+        first = parent + 1 > tracker->cursor ? parent + 1 : tracker->cursor;
+    for (uint64_t s = first; s <= slot; ++s)
+        set_bit(tracker, s);
+    if (slot > tracker->highest)
+        tracker->highest = slot;
+    if (tracker->highest > tracker->grace && tracker->highest - tracker->grace > tracker->cursor)
+        sweep(tracker, tracker->highest - tracker->grace);
+    pthread_mutex_unlock(&tracker->lock);
+}
+
+bool slot_tracker_next_gap(yurei_slot_tracker_t *tracker, yurei_slot_gap_t *gap) {
+    pthread_mutex_lock(&tracker->lock);
+    // A gap reaching the cursor may still grow; wait until a slot closes it
+    bool found = tracker->gap_count > 1 ||
+                 (tracker->gap_count == 1 && tracker->gaps[tracker->gap_head].end < tracker->cursor);
+    if (found) {
+        *gap = tracker->gaps[tracker->gap_head];
+        tracker->gap_head = (tracker->gap_head + 1) % tracker->max_gaps;
+        tracker->gap_count--;
+    }
+    pthread_mutex_unlock(&tracker->lock);
+    return found;
+}
@@ -0,0 +1,269 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "stream_recorder.h"
+
+#include "log.h"
+#include "metrics.h"
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RECORDER_FILE_BUFFER (1u << 20)
+
+// Producers append whole records at `tail`; the writer thread consumes them
+// from `head`.  Both are running byte counts, so `tail - head` is the fill
+// level and `% capacity` the ring offset.  Bytes in [head, tail) belong to
+// the writer and are read without the lock.
+struct yurei_stream_recorder {
+    char dir[PATH_MAX];
+    size_t segment_bytes;
+    uint8_t *ring;
+    size_t capacity;
+    uint64_t head;
+    uint64_t tail;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    bool stopping;
+    pthread_t thread;
+
+    // Writer thread state
+    FILE *fp;
+    char *file_buffer;
+    size_t segment_written;
+    unsigned segment_seq;
+    long long started_at;
+    bool open_failed;
+};
+
+static void ring_put(struct yurei_stream_recorder *recorder, uint64_t at, const void *src, size_t len) {
+    size_t offset = (size_t)(at % recorder->capacity);
+    size_t first = recorder->capacity - offset;
+    if (first > len)
+        first = len;
+    memcpy(recorder->ring + offset, src, first);
+    memcpy(recorder->ring, (const uint8_t *)src + first, len - first);
+}
+
+static void ring_get(const struct yurei_stream_recorder *recorder, uint64_t at, void *dst, size_t len) {
+    size_t offset = (size_t)(at % recorder->capacity);
+    size_t first = recorder->capacity - offset;
+    if (first > len)
+        first = len;
+    memcpy(dst, recorder->ring + offset, first);
+    memcpy((uint8_t *)dst + first, recorder->ring, len - first);
+}
+
+static void put_le(uint8_t *out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i)
+        out[i] = (uint8_t)(value >> (8 * i));
+}
+
+static uint64_t get_le(const uint8_t *in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i)
+        value |= (uint64_t)in[i] << (8 * i);
+    return value;
+}
+
+static void close_segment(struct yurei_stream_recorder *recorder) {
+    if (!recorder->fp)
+        return;
+    if (fclose(recorder->fp) != 0)
+        LOG_WARN("capture: closing segment failed");
+    recorder->fp = NULL;
+}
+
+static bool open_segment(struct yurei_stream_recorder *recorder) {
+    char path[PATH_MAX + 64];
+    snprintf(path, sizeof(path), "%s/yurei-%lld-%06u.cap", recorder->dir, recorder->started_at,
+             recorder->segment_seq);
+    recorder->fp = fopen(path, "wb");
+    if (!recorder->fp) {
+        if (!recorder->open_failed)
+            LOG_ERROR("capture: cannot create %s; dropping records until it can", path);
+        recorder->open_failed = true;
+        return false;
+    }
+    setvbuf(recorder->fp, recorder->file_buffer, _IOFBF, RECORDER_FILE_BUFFER);
+    fwrite(YUREI_CAPTURE_MAGIC, 1, YUREI_CAPTURE_MAGIC_LEN, recorder->fp);
+    recorder->segment_seq++;
+    recorder->segment_written = YUREI_CAPTURE_MAGIC_LEN;
+    recorder->open_failed = false;
+    metrics_inc_capture_segment();
+    LOG_INFO("capture: writing %s", path);
+    return true;
+}
+
+// Writes the records in [from, to), rotating segments between records.
+static void write_records(struct yurei_stream_recorder *recorder, uint64_t from, uint64_t to) {
+    uint8_t chunk[4096];
+    uint64_t records = 0;
+    uint64_t bytes = 0;
+    while (from < to) {
+        uint8_t header[YUREI_CAPTURE_RECORD_HEADER];
+        ring_get(recorder, from, header, sizeof(header));
+        size_t len = (size_t)get_le(header + 8, 4);
+        size_t record_len = sizeof(header) + len;
+        if (recorder->fp && recorder->segment_written + record_len > recorder->segment_bytes &&
+            recorder->segment_written > YUREI_CAPTURE_MAGIC_LEN)
+            close_segment(recorder);
+        if (!recorder->fp && !open_segment(recorder)) {
+            metrics_inc_capture_dropped();
+            from += record_len;
+            continue;
+        }
+        fwrite(header, 1, sizeof(header), recorder->fp);
+        for (size_t done = 0; done < len;) {
+            size_t n = len - done < sizeof(chunk) ? len - done : sizeof(chunk);
+            ring_get(recorder, from + sizeof(header) + done, chunk, n);
+            fwrite(chunk, 1, n, recorder->fp);
+            done += n;
+        }
+        recorder->segment_written += record_len;
+        from += record_len;
+        records++;
+        bytes += record_len;
+    }
+    if (recorder->fp && fflush(recorder->fp) != 0) {
+        LOG_ERROR("capture: write failed, starting a new segment");
+        close_segment(recorder);
+    }
+    metrics_add_capture(records, bytes);
+}
+
+static void *recorder_main(void *arg) {
+    struct yurei_stream_recorder *recorder = arg;
+    pthread_mutex_lock(&recorder->lock);
+    while (true) {
+        while (!recorder->stopping && recorder->tail == recorder->head)
+            pthread_cond_wait(&recorder->ready, &recorder->lock);
+        uint64_t from = recorder->head;
+        uint64_t to = recorder->tail;
+        if (from == to && recorder->stopping)
+            break;
+        pthread_mutex_unlock(&recorder->lock);
+        write_records(recorder, from, to);
+        pthread_mutex_lock(&recorder->lock);
+        recorder->head = to;
+    }
+    pthread_mutex_unlock(&recorder->lock);
+    close_segment(recorder);
+    return NULL;
+}
+
+yurei_stream_recorder_t *stream_recorder_create(const char *dir, size_t segment_bytes, size_t buffer_bytes) {
+    if (!dir || !*dir || buffer_bytes < 4096)
+        return NULL;
+    struct yurei_stream_recorder *recorder = calloc(1, sizeof(*recorder));
+    if (!recorder)
+        return NULL;
+    snprintf(recorder->dir, sizeof(recorder->dir), "%s", dir);
+    recorder->segment_bytes = segment_bytes;
+    recorder->capacity = buffer_bytes;
+    recorder->ring = malloc(buffer_bytes);
+    recorder->file_buffer = malloc(RECORDER_FILE_BUFFER);
+    recorder->started_at = (long long)time(NULL);
+    if (!recorder->ring || !recorder->file_buffer) {
+        free(recorder->ring);
+        free(recorder->file_buffer);
+        free(recorder);
+        return NULL;
+    }
+    pthread_mutex_init(&recorder->lock, NULL);
+    pthread_cond_init(&recorder->ready, NULL);
+    if (pthread_create(&recorder->thread, NULL, recorder_main, recorder) != 0) {
+        pthread_mutex_destroy(&recorder->lock);
+        pthread_cond_destroy(&recorder->ready);
+        free(recorder->ring);
+        free(recorder->file_buffer);
+        free(recorder);
+        return NULL;
+    }
+    return recorder;
+}
+
+bool stream_recorder_write(yurei_stream_recorder_t *recorder, int64_t recv_unix_ns, const uint8_t *data, size_t len) {
+    uint8_t header[YUREI_CAPTURE_RECORD_HEADER];
+    put_le(header, (uint64_t)recv_unix_ns, 8);
+    put_le(header + 8, (uint64_t)len, 4);
+    size_t record_len = sizeof(header) + len;
+    pthread_mutex_lock(&recorder->lock);
+    if (len > UINT32_MAX || recorder->stopping ||
+        record_len > recorder->capacity - (size_t)(recorder->tail - recorder->head)) {
+        pthread_mutex_unlock(&recorder->lock);
+        metrics_inc_capture_dropped();
+        return false;
+    }
+    ring_put(recorder, recorder->tail, header, sizeof(header));
+    ring_put(recorder, recorder->tail + sizeof(header), data, len);
+    bool was_empty = recorder->tail == recorder->head;
+    recorder->tail += record_len;
+    if (was_empty)
+        pthread_cond_signal(&recorder->ready);
+    pthread_mutex_unlock(&recorder->lock);
+    return true;
+}
+
+void stream_recorder_destroy(yurei_stream_recorder_t *recorder) {
+    if (!recorder)
+        return;
+    pthread_mutex_lock(&recorder->lock);
+    recorder->stopping = true;
+    pthread_cond_signal(&recorder->ready);
+    pthread_mutex_unlock(&recorder->lock);
+    pthread_join(recorder->thread, NULL);
+    pthread_mutex_destroy(&recorder->lock);
+    pthread_cond_destroy(&recorder->ready);
+    free(recorder->ring);
+    free(recorder->file_buffer);
+    free(recorder);
+}
+
+bool capture_reader_open(yurei_capture_reader_t *reader, const char *path) {
+    memset(reader, 0, sizeof(*reader));
+    reader->fp = fopen(path, "rb");
+    if (!reader->fp)
+        return false;
+    char magic[YUREI_CAPTURE_MAGIC_LEN];
+    if (fread(magic, 1, sizeof(magic), reader->fp) != sizeof(magic) ||
+        memcmp(magic, YUREI_CAPTURE_MAGIC, sizeof(magic)) != 0) {
+        fclose(reader->fp);
+        reader->fp = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool capture_reader_next(yurei_capture_reader_t *reader, int64_t *recv_unix_ns, const uint8_t **data, size_t *len) {
+    uint8_t header[YUREI_CAPTURE_RECORD_HEADER];
+    if (!reader->fp || fread(header, 1, sizeof(header), reader->fp) != sizeof(header))
+        return false;
+    size_t record_len = (size_t)get_le(header + 8, 4);
+    if (record_len > reader->capacity) {
+        uint8_t *grown = realloc(reader->buffer, record_len);
+        if (!grown)
+            return false;
+        reader->buffer = grown;
+        reader->capacity = record_len;
+    }
+    if (fread(reader->buffer, 1, record_len, reader->fp) != record_len)
+        return false;
+    *recv_unix_ns = (int64_t)get_le(header, 8);
+    *data = reader->buffer;
+    *len = record_len;
+    return true;
+}
+
+void capture_reader_close(yurei_capture_reader_t *reader) {
+    if (reader->fp)
+        fclose(reader->fp);
+    free(reader->buffer);
+    memset(reader, 0, sizeof(*reader));
+}
@@ -0,0 +1,87 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#define _GNU_SOURCE  // cpu_set_t, pthread_setaffinity_np
+
+#include "topology.h"
+
+#include "log.h"
+
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool topology_parse_cpus(const char *list, yurei_cpu_list_t *out) {
+    out->count = 0;
+    if (!list)
+        return true;
+    const char *cursor = list;
+    while (*cursor) {
+        char *end = NULL;
+        unsigned long first = strtoul(cursor, &end, 10);
+        if (end == cursor)
+            return false;
+        unsigned long last = first;
+        if (*end == '-') {
+            const char *next = end + 1;
+            last = strtoul(next, &end, 10);
+            if (end == next || last < first)
+                return false;
+        }
+        if (last >= CPU_SETSIZE)
+            return false;
+        for (unsigned long cpu = first; cpu <= last; ++cpu) {
+            if (out->count == YUREI_MAX_CPUS)
+                return false;
+            out->cpus[out->count++] = (uint16_t)cpu;
+        }
+        if (*end == ',') {
+            end++;
+        } else if (*end != '\0') {
+            return false;
+        }
+        cursor = end;
+    }
+    return true;
+}
+
+static bool apply(pthread_t thread, const cpu_set_t *set) {
+    int rc = pthread_setaffinity_np(thread, sizeof(*set), set);
+    if (rc != 0) {
+        LOG_WARN("setting CPU affinity failed: %s", strerror(rc));
+        return false;
+    }
+    return true;
+}
+
+bool topology_pin_thread(pthread_t thread, const yurei_cpu_list_t *cpus, size_t index) {
+    if (!cpus || cpus->count == 0)
+        return true;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus->cpus[index % cpus->count], &set);
+    return apply(thread, &set);
+}
+
+bool topology_bind_thread(pthread_t thread, const yurei_cpu_list_t *cpus) {
+    if (!cpus || cpus->count == 0)
+        return true;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (size_t i = 0; i < cpus->count; ++i)
+        CPU_SET(cpus->cpus[i], &set);
+    return apply(thread, &set);
+}
+
+bool topology_current_cpus(yurei_cpu_list_t *out) {
+    out->count = 0;
+    cpu_set_t set;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+        return false;
+    for (int cpu = 0; cpu < CPU_SETSIZE && out->count < YUREI_MAX_CPUS; ++cpu) {
+        if (CPU_ISSET(cpu, &set))
+            out->cpus[out->count++] = (uint16_t)cpu;
+    }
+    return out->count > 0;
+}
@@ -0,0 +1,438 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#include "update_scanner.h"
+
+#include <string.h>
+
+enum {
+    WIRE_VARINT = 0,
+    WIRE_FIXED64 = 1,
+    WIRE_LEN = 2,
+    WIRE_FIXED32 = 5
+};
+
+typedef struct {
+    const uint8_t *pos;
+    const uint8_t *end;
+} wire_reader_t;
+
+typedef struct {
+    uint32_t field;
+    uint32_t wire_type;
+    uint64_t varint;
+    const uint8_t *data;
+    size_t len;
+} wire_field_t;
+
+static bool read_varint(wire_reader_t *r, uint64_t *out) {
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (r->pos >= r->end)
+            return false;
+        uint8_t byte = *r->pos++;
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *out = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Reads the next field header and payload.  Length-delimited payloads are
+// returned as borrowed slices; fixed-width payloads are skipped.
+static bool next_field(wire_reader_t *r, wire_field_t *f) {
+    uint64_t key = 0;
+    if (!read_varint(r, &key))
+        return false;
+    f->field = (uint32_t)(key >> 3);
+    f->wire_type = (uint32_t)(key & 0x7);
+    f->data = NULL;
+    f->len = 0;
+    f->varint = 0;
+    switch (f->wire_type) {
+    case WIRE_VARINT:
+        return read_varint(r, &f->varint);
+    case WIRE_FIXED64:
+        if ((size_t)(r->end - r->pos) < 8)
+            return false;
+        r->pos += 8;
+        return true;
+    case WIRE_FIXED32:
+        if ((size_t)(r->end - r->pos) < 4)
+            return false;
+        r->pos += 4;
+        return true;
+    case WIRE_LEN: {
+        uint64_t len = 0;
+        if (!read_varint(r, &len) || len > (uint64_t)(r->end - r->pos))
+            return false;
+        f->data = r->pos;
+        f->len = (size_t)len;
+        r->pos += len;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+static bool scan_message(const uint8_t *data, size_t len, yurei_tx_view_t *out) {
+    // solana.storage.ConfirmedBlock.Message
+    wire_reader_t r = {data, data + len};
+    wire_field_t f;
+    while (r.pos < r.end) {
+        if (!next_field(&r, &f))
+            return false;
+        if (f.field == 2 && f.wire_type == WIRE_LEN) {
+            if (out->n_account_keys == YUREI_TX_MAX_ACCOUNTS) {
+                out->truncated = true;
+                continue;
+            }
+            out->account_keys[out->n_account_keys] = f.data;
+            out->account_key_lens[out->n_account_keys] = f.len;
+            out->n_account_keys++;
+        }
+    }
+    return true;
+}
+
+static bool scan_transaction(const uint8_t *data, size_t len, yurei_tx_view_t *out) {
+    // solana.storage.ConfirmedBlock.Transaction
+    wire_reader_t r = {data, data + len};
+    wire_field_t f;
+    while (r.pos < r.end) {
+        if (!next_field(&r, &f))
+            return false;
+        if (f.field == 2 && f.wire_type == WIRE_LEN && !scan_message(f.data, f.len, out))
+            return false;
+    }
+    return true;
+}
+
+static bool scan_meta(const uint8_t *data, size_t len, yurei_tx_view_t *out) {
+    // solana.storage.ConfirmedBlock.TransactionStatusMeta
+    wire_reader_t r = {data, data + len};
+    wire_field_t f;
+    while (r.pos < r.end) {
+        if (!next_field(&r, &f))
+            return false;
+        if (f.field == 6 && f.wire_type == WIRE_LEN) {
+            if (out->n_log_messages == YUREI_TX_MAX_LOGS) {
+                out->truncated = true;
+                continue;
+            }
+            out->log_messages[out->n_log_messages] = (const char *)f.data;
+            out->log_message_lens[out->n_log_messages] = f.len;
+            out->n_log_messages++;
+        }
+    }
+    return true;
+}
+
+static bool scan_transaction_info(const uint8_t *data, size_t len, yurei_tx_view_t *out) {
+    // geyser.SubscribeUpdateTransactionInfo
+    wire_reader_t r = {data, data + len};
+    wire_field_t f;
+    while (r.pos < r.end) {
+        if (!next_field(&r, &f))
+            return false;
+        if (f.field == 5 && f.wire_type == WIRE_VARINT) {
+            out->has_tx_index = true;
+            out->tx_index = f.varint;
+            continue;
+        }
+        if (f.wire_type != WIRE_LEN)
+            continue;
+        switch (f.field) {
+        case 1:
+            out->signature = f.data;
+            out->signature_len = f.len;
+            break;
+        case 3:
+            if (!scan_transaction(f.data, f.len, out))
+                return false;
+            break;
+        case 4:
+            if (!scan_meta(f.data, f.len, out))
+                return false;
+            break;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+static bool scan_transaction_update(const uint8_t *data, size_t len, yurei_tx_view_t *out) {
+    // geyser.SubscribeUpdateTransaction
+    wire_reader_t r = {data, data + len};
+    wire_field_t f;
+    while (r.pos < r.end) {
+        if (!next_field(&r, &f))
+            return false;
+        if (f.field == 1 && f.wire_type == WIRE_LEN) {
+            if (!scan_transaction_info(f.data, f.len, out))
+                return false;
+        } else if (f.field == 2 && f.wire_type == WIRE_VARINT) {
+            out->has_slot = true;
+            out->slot = f.varint;
+        }
+    }
+    return true;
+}
+
+static bool scan_pong(const uint8_t *data, size_t len, yurei_tx_view_t *out) {
+    // geyser.SubscribeUpdatePong
+    wire_reader_t r = {data, data + len};
+    wire_field_t f;
+    while (r.pos < r.end) {
+        if (!next_field(&r, &f))
+            return false;
+        if (f.field == 1 && f.wire_type == WIRE_VARINT)
+            out->pong_id = (int32_t)f.varint;
+    }
+    return true;
+}
+
+static bool scan_slot_update(const uint8_t *data, size_t len, yurei_tx_view_t *out) {
+    // geyser.SubscribeUpdateSlot
+    wire_reader_t r = {data, data + len};
+    wire_field_t f;
+    while (r.pos < r.end) {
+        if (!next_field(&r, &f))
+            return false;
+        if (f.wire_type != WIRE_VARINT)
+            continue;
+        switch (f.field) {
+        case 1:
+            out->has_slot = true;
+            out->slot = f.varint;
+            break;
+        case 2:
+            out->has_parent_slot = true;
+            out->parent_slot = f.varint;
+            break;
+        case 3:
+            out->slot_status = (int32_t)f.varint;
+            break;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+static bool scan_account_info(const uint8_t *data, size_t len, yurei_tx_view_t *out) {
+    // geyser.SubscribeUpdateAccountInfo
+    wire_reader_t r = {data, data + len};
+    wire_field_t f;
+    while (r.pos < r.end) {
+        if (!next_field(&r, &f))
+            return false;
+        if (f.field == 1 && f.wire_type == WIRE_LEN) {
+            out->account_pubkey = f.data;
+            out->account_pubkey_len = f.len;
+        } else if (f.field == 3 && f.wire_type == WIRE_LEN) {
+            out->account_owner = f.data;
+            out->account_owner_len = f.len;
+        } else if (f.field == 6 && f.wire_type == WIRE_LEN) {
+            out->account_data = f.data;
+            out->account_data_len = f.len;
+        } else if (f.field == 7 && f.wire_type == WIRE_VARINT) {
+            out->write_version = f.varint;
+        }
+    }
+    return true;
+}
+
+static bool scan_account_update(const uint8_t *data, size_t len, yurei_tx_view_t *out) {
+    // geyser.SubscribeUpdateAccount
+    wire_reader_t r = {data, data + len};
+    wire_field_t f;
+    while (r.pos < r.end) {
+        if (!next_field(&r, &f))
+            return false;
+        if (f.field == 1 && f.wire_type == WIRE_LEN) {
+            if (!scan_account_info(f.data, f.len, out))
+                return false;
+        } else if (f.field == 2 && f.wire_type == WIRE_VARINT) {
+            out->has_slot = true;
+            out->slot = f.varint;
+        }
+    }
+    return true;
+}
+
+static bool scan_block_update(const uint8_t *data, size_t len, yurei_tx_view_t *out) {
+    // geyser.SubscribeUpdateBlock; transactions (6) are left for the cursor
+    wire_reader_t r = {data, data + len};
+    wire_field_t f;
+    out->block_data = data;
+    out->block_len = len;
+    while (r.pos < r.end) {
+        if (!next_field(&r, &f))
+            return false;
+        if (f.field == 1 && f.wire_type == WIRE_VARINT) {
+            out->has_slot = true;
+            out->slot = f.varint;
+        } else if (f.field == 7 && f.wire_type == WIRE_VARINT) {
+            out->has_parent_slot = true;
+            out->parent_slot = f.varint;
+        } else if (f.field == 4 && f.wire_type == WIRE_LEN) {
+            // solana.storage.ConfirmedBlock.UnixTimestamp
+            wire_reader_t ts = {f.data, f.data + f.len};
+            wire_field_t tf;
+            while (ts.pos < ts.end) {
+                if (!next_field(&ts, &tf))
+                    return false;
+                if (tf.field == 1 && tf.wire_type == WIRE_VARINT) {
+                    out->has_block_time = true;
+                    out->block_time = (int64_t)tf.varint;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static bool scan_timestamp(const uint8_t *data, size_t len, int64_t *out_ns) {
+    // google.protobuf.Timestamp
+    wire_reader_t r = {data, data + len};
+    wire_field_t f;
+    int64_t seconds = 0;
+    int64_t nanos = 0;
+    while (r.pos < r.end) {
+        if (!next_field(&r, &f))
+            return false;
+        if (f.field == 1 && f.wire_type == WIRE_VARINT)
+            seconds = (int64_t)f.varint;
+        else if (f.field == 2 && f.wire_type == WIRE_VARINT)
+            nanos = (int32_t)f.varint;
+    }
+    *out_ns = seconds * 1000000000ll + nanos;
+    return true;
+}
+
+static void reset_view(yurei_tx_view_t *out) {
+    out->kind = YUREI_UPDATE_NONE;
+    out->encoded_len = 0;
+    out->n_filters = 0;
+    out->has_created_at = false;
+    out->created_at_ns = 0;
+    out->has_slot = false;
+    out->slot = 0;
+    out->signature = NULL;
+    out->signature_len = 0;
+    out->has_tx_index = false;
+    out->tx_index = 0;
+    out->n_account_keys = 0;
+    out->n_log_messages = 0;
+    out->truncated = false;
+    out->pong_id = 0;
+    out->parent_slot = 0;
+    out->has_parent_slot = false;
+    out->slot_status = 0;
+    out->account_pubkey = NULL;
+    out->account_pubkey_len = 0;
+    out->account_owner = NULL;
+    out->account_owner_len = 0;
+    out->account_data = NULL;
+    out->account_data_len = 0;
+    out->write_version = 0;
+    out->has_block_time = false;
+    out->block_time = 0;
+    out->block_data = NULL;
+    out->block_len = 0;
+}
+
+void update_scanner_block_begin(const yurei_tx_view_t *block, yurei_block_cursor_t *cursor) {
+    cursor->pos = block->block_data;
+    cursor->end = block->block_data ? block->block_data + block->block_len : NULL;
+    cursor->malformed = false;
+}
+
+bool update_scanner_block_next(yurei_block_cursor_t *cursor, const yurei_tx_view_t *block, yurei_tx_view_t *out) {
+    wire_reader_t r = {cursor->pos, cursor->end};
+    wire_field_t f;
+    while (r.pos < r.end) {
+        if (!next_field(&r, &f)) {
+            cursor->malformed = true;
+            cursor->pos = cursor->end;
+            return false;
+        }
+        if (f.field != 6 || f.wire_type != WIRE_LEN)
+            continue;
+        cursor->pos = r.pos;
+        reset_view(out);
+        out->kind = YUREI_UPDATE_TRANSACTION;
+        out->encoded_len = f.len;
+        out->has_slot = block->has_slot;
+        out->slot = block->slot;
+        out->has_block_time = block->has_block_time;
+        out->block_time = block->block_time;
+        out->has_created_at = block->has_created_at;
+        out->created_at_ns = block->created_at_ns;
+        if (!scan_transaction_info(f.data, f.len, out)) {
+            cursor->malformed = true;
+            cursor->pos = cursor->end;
+            return false;
+        }
+        return true;
+    }
+    cursor->pos = cursor->end;
+    return false;
+}
+
+bool update_scanner_scan(const uint8_t *data, size_t len, yurei_tx_view_t *out) {
+    if (!out || (!data && len > 0))
+        return false;
+    reset_view(out);
+    out->encoded_len = len;
+
+    // geyser.SubscribeUpdate: the transaction payload is located first and
+    // scanned once, so a message that repeats the oneof keeps the last one.
+    wire_reader_t r = {data, data + len};
+    wire_field_t f;
+    const uint8_t *tx_data = NULL;
+    size_t tx_len = 0;
+    while (r.pos < r.end) {
+        if (!next_field(&r, &f))
+            return false;
+        if (f.field == 1 && f.wire_type == WIRE_LEN) {
+            // repeated string filters
+            if (out->n_filters < YUREI_UPDATE_MAX_FILTERS) {
+                out->filters[out->n_filters] = (const char *)f.data;
+                out->filter_lens[out->n_filters] = f.len;
+                out->n_filters++;
+            }
+            continue;
+        }
+        if (f.field == 11 && f.wire_type == WIRE_LEN) {
+            if (!scan_timestamp(f.data, f.len, &out->created_at_ns))
+                return false;
+            out->has_created_at = true;
+            continue;
+        }
+        if (f.wire_type != WIRE_LEN || f.field < YUREI_UPDATE_ACCOUNT || f.field > YUREI_UPDATE_TRANSACTION_STATUS)
+            continue;
+        out->kind = (yurei_update_kind_t)f.field;
+        if (f.field == YUREI_UPDATE_TRANSACTION) {
+            tx_data = f.data;
+            tx_len = f.len;
+        } else if (f.field == YUREI_UPDATE_PONG && !scan_pong(f.data, f.len, out)) {
+            return false;
+        } else if (f.field == YUREI_UPDATE_SLOT && !scan_slot_update(f.data, f.len, out)) {
+            return false;
+        } else if (f.field == YUREI_UPDATE_ACCOUNT && !scan_account_update(f.data, f.len, out)) {
+            return false;
+        } else if (f.field == YUREI_UPDATE_BLOCK && !scan_block_update(f.data, f.len, out)) {
+            return false;
+        }
+    }
+    if (out->kind != YUREI_UPDATE_TRANSACTION)
+        return true;
+    return scan_transaction_update(tx_data, tx_len, out);
+}
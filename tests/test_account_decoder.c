@@ -0,0 +1,93 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#include <assert.h>
+#include <string.h>
+
+#include "account_decoder.h"
+
+// What the server sends back for accounts_data_slice: each range of the
+// account data, concatenated in request order.
+static size_t apply_slices(const yurei_account_layout_t *layout,
+                           const uint8_t *account, size_t account_len,
+                           uint8_t *out) {
+    size_t len = 0;
+    for (size_t i = 0; i < layout->n_slices; ++i) {
+        size_t offset = layout->slices[i].offset;
+        size_t length = layout->slices[i].length;
+        if (offset >= account_len)
+            continue;
+        if (offset + length > account_len)
+            length = account_len - offset;
+        memcpy(out + len, account + offset, length);
+        len += length;
+    }
+    return len;
+}
+
+static void put_u64(uint8_t *dst, uint64_t v) {
+    memcpy(dst, &v, sizeof(v));
+}
+
+int main(void) {
+    uint8_t pubkey[32];
+    for (int i = 0; i < 32; ++i)
+        pubkey[i] = (uint8_t)(0xA0 + i);
+    uint8_t sliced[1024];
+
+    // PumpFun bonding curve with a creator
+    uint8_t curve[81] = {0};
+    memcpy(curve, account_decoder_pumpfun_curve_discriminator, 8);
+    put_u64(curve + 8, 1073000000000000ULL);
+    put_u64(curve + 16, 30000000000ULL);
+    put_u64(curve + 24, 793100000000000ULL);
+    put_u64(curve + 32, 1500000000ULL);
+    put_u64(curve + 40, 1000000000000000ULL);
+    curve[48] = 1;
+    for (int i = 0; i < 32; ++i)
+        curve[49 + i] = (uint8_t)i;
+    size_t len = apply_slices(&account_layout_pumpfun_curve, curve, sizeof(curve), sliced);
+    assert(len == 73);
+    yurei_pumpfun_curve_t state;
+    assert(account_decode_pumpfun_curve(pubkey, sliced, len, &state));
+    assert(memcmp(state.bonding_curve, pubkey, 32) == 0);
+    assert(state.virtual_token_reserves == 1073000000000000ULL);
+    assert(state.virtual_sol_reserves == 30000000000ULL);
+    assert(state.real_token_reserves == 793100000000000ULL);
+    assert(state.real_sol_reserves == 1500000000ULL);
+    assert(state.token_total_supply == 1000000000000000ULL);
+    assert(state.complete);
+    assert(state.has_creator && state.creator[31] == 31);
+
+    // Curves from before the creator field come back short
+    len = apply_slices(&account_layout_pumpfun_curve, curve, 49, sliced);
+    assert(len == 41);
+    assert(account_decode_pumpfun_curve(pubkey, sliced, len, &state));
+    assert(!state.has_creator);
+    assert(!account_decode_pumpfun_curve(pubkey, sliced, 40, &state));
+
+    // Raydium AmmInfo
+    uint8_t amm[YUREI_RAYDIUM_AMM_INFO_SIZE] = {0};
+    put_u64(amm + 0, 6);
+    put_u64(amm + 32, 9);
+    put_u64(amm + 40, 6);
+    put_u64(amm + 192, 111);
+    put_u64(amm + 200, 222);
+    for (int k = 0; k < 5; ++k)
+        memset(amm + 336 + 32 * k, 0x10 + k, 32);
+    put_u64(amm + 720, 424242);
+    len = apply_slices(&account_layout_raydium_pool, amm, sizeof(amm), sliced);
+    assert(len == account_layout_raydium_pool.min_len);
+    yurei_raydium_pool_t pool;
+    assert(account_decode_raydium_pool(pubkey, sliced, len, &pool));
+    assert(memcmp(pool.amm, pubkey, 32) == 0);
+    assert(pool.status == 6);
+    assert(pool.coin_decimals == 9 && pool.pc_decimals == 6);
+    assert(pool.need_take_pnl_coin == 111 && pool.need_take_pnl_pc == 222);
+    assert(pool.coin_vault[0] == 0x10 && pool.pc_vault[0] == 0x11);
+    assert(pool.coin_mint[0] == 0x12 && pool.pc_mint[0] == 0x13 && pool.lp_mint[31] == 0x14);
+    assert(pool.lp_amount == 424242);
+    assert(!account_decode_raydium_pool(pubkey, sliced, len - 1, &pool));
+    return 0;
+}
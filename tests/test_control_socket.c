@@ -0,0 +1,72 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#define _DEFAULT_SOURCE  // struct sockaddr_un
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "control_socket.h"
+
+static int commands_seen = 0;
+
+static void echo_handler(void *ctx, char *command, char *reply, size_t reply_len) {
+    int *seen = ctx;
+    (*seen)++;
+    snprintf(reply, reply_len, "ok %s", command);
+}
+
+static size_t read_line(int fd, char *buf, size_t len) {
+    size_t used = 0;
+    while (used + 1 < len) {
+        ssize_t n = read(fd, buf + used, 1);
+        assert(n == 1);
+        if (buf[used] == '\n')
+            break;
+        used++;
+    }
+    buf[used] = '\0';
+    return used;
+}
+
+int main(void) {
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/yurei-control-test-%d.sock", (int)getpid());
+    control_socket_t *sock = control_socket_start(path, echo_handler, &commands_seen);
+    assert(sock);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    assert(fd >= 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path, strlen(path));
+    assert(connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+
+    // Two commands in one write, the second split across writes.
+    const char *first = "status\r\ncommit";
+    assert(write(fd, first, strlen(first)) == (ssize_t)strlen(first));
+    char line[128];
+    read_line(fd, line, sizeof(line));
+    assert(strcmp(line, "ok status") == 0);
+    const char *rest = "ment confirmed\n";
+    assert(write(fd, rest, strlen(rest)) == (ssize_t)strlen(rest));
+    read_line(fd, line, sizeof(line));
+    assert(strcmp(line, "ok commitment confirmed") == 0);
+
+    // Blank lines are acknowledged without reaching the handler.
+    assert(write(fd, "\n", 1) == 1);
+    read_line(fd, line, sizeof(line));
+    assert(line[0] == '\0');
+    assert(commands_seen == 2);
+
+    close(fd);
+    control_socket_stop(sock);
+    assert(access(path, F_OK) != 0);
+    return 0;
+}
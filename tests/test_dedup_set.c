@@ -0,0 +1,55 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "dedup_set.h"
+
+static void make_signature(uint8_t sig[64], uint32_t seed) {
+    uint32_t x = seed * 2654435761u + 1;
+    for (int i = 0; i < 64; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        sig[i] = (uint8_t)x;
+    }
+}
+
+int main(void) {
+    yurei_dedup_set_t *set = dedup_set_create(4096, 32);
+    assert(set);
+
+    uint8_t sig[64];
+    make_signature(sig, 1);
+    uint32_t first_source = 99;
+    uint64_t first_ns = 0;
+
+    // First arrival wins, later copies from other endpoints are duplicates.
+    assert(dedup_set_insert(set, sig, 64, 1000, 0, 500, &first_source, &first_ns));
+    assert(!dedup_set_insert(set, sig, 64, 1000, 1, 700, &first_source, &first_ns));
+    assert(first_source == 0 && first_ns == 500);
+
+    // A copy received earlier but inserted later replaces the stored arrival.
+    assert(!dedup_set_insert(set, sig, 64, 1000, 2, 300, &first_source, &first_ns));
+    assert(first_source == 0 && first_ns == 500);
+    assert(!dedup_set_insert(set, sig, 64, 1000, 1, 800, &first_source, &first_ns));
+    assert(first_source == 2 && first_ns == 300);
+
+    // The slot is part of the key.
+    assert(dedup_set_insert(set, sig, 64, 1001, 0, 900, NULL, NULL));
+
+    // Memory is bounded: far more distinct pairs than capacity still insert,
+    // and recent pairs are still recognised afterwards.
+    for (uint32_t i = 0; i < 100000; ++i) {
+        make_signature(sig, 1000 + i);
+        assert(dedup_set_insert(set, sig, 64, 2000 + i / 100, 0, i, NULL, NULL));
+    }
+    make_signature(sig, 1000 + 99999);
+    assert(!dedup_set_insert(set, sig, 64, 2000 + 99999 / 100, 1, 100000, NULL, NULL));
+
+    dedup_set_destroy(set);
+    return 0;
+}
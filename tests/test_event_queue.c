@@ -0,0 +1,117 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#define _DEFAULT_SOURCE  // usleep
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "event_queue.h"
+
+static yurei_event_t trade(uint64_t slot, bool backfill) {
+    yurei_event_t event;
+    memset(&event, 0, sizeof(event));
+    event.type = YUREI_EVENT_PUMPFUN_TRADE;
+    event.backfill = backfill;
+    event.data.pumpfun_trade.slot = slot;
+    return event;
+}
+
+typedef struct {
+    yurei_event_queue_t *queue;
+    const yurei_event_t *events;
+    size_t count;
+} producer_t;
+
+static void *push_batch_thread(void *arg) {
+    producer_t *producer = arg;
+    assert(event_queue_push_batch(producer->queue, producer->events, producer->count));
+    return NULL;
+}
+
+// Blocks arrive as contiguous runs even when producers race a full ring.
+static void check_batches_stay_whole(void) {
+    yurei_event_queue_t *queue = event_queue_create(4);
+    assert(queue);
+    yurei_event_t filler = trade(1, false);
+    for (int i = 0; i < 3; ++i)
+        assert(event_queue_push(queue, &filler));
+
+    // Two events need two free slots: the batch waits instead of splitting.
+    yurei_event_t pair[2] = {trade(20, false), trade(20, false)};
+    // Larger than the ring: written in pieces with everyone else held off.
+    yurei_event_t block[10];
+    for (int i = 0; i < 10; ++i)
+        block[i] = trade(30, false);
+    producer_t producers[2] = {{queue, pair, 2}, {queue, block, 10}};
+    pthread_t threads[2];
+    assert(pthread_create(&threads[0], NULL, push_batch_thread, &producers[0]) == 0);
+    assert(pthread_create(&threads[1], NULL, push_batch_thread, &producers[1]) == 0);
+    usleep(20000);
+    assert(event_queue_size(queue) == 3);
+
+    yurei_event_t event;
+    uint64_t last = 0;
+    size_t run = 0;
+    size_t popped = 0;
+    while (popped < 15) {
+        if (!event_queue_pop(queue, &event, false)) {
+            usleep(100);
+            continue;
+        }
+        popped++;
+        uint64_t slot = event.data.pumpfun_trade.slot;
+        if (slot != last) {
+            // A slot never comes back once another one started
+            assert(last == 0 || run == (last == 1 ? 3 : last == 20 ? 2 : 10));
+            last = slot;
+            run = 0;
+        }
+        run++;
+    }
+    assert(run == (last == 20 ? 2 : 10));
+    pthread_join(threads[0], NULL);
+    pthread_join(threads[1], NULL);
+    event_queue_destroy(queue);
+}
+
+int main(void) {
+    check_batches_stay_whole();
+
+    yurei_event_queue_t *queue = event_queue_create(16);
+    assert(queue);
+    yurei_event_t history[3] = {trade(10, true), trade(11, true), trade(12, true)};
+
+    // Without the lane, backfill is refused rather than mixed into live.
+    assert(!event_queue_push_backfill(queue, history, 3));
+    assert(event_queue_enable_backfill(queue, 8));
+    assert(event_queue_push_backfill(queue, history, 3));
+
+    yurei_event_t live = trade(500, false);
+    assert(event_queue_push(queue, &live));
+    assert(event_queue_push(queue, &live));
+
+    // Live events go first, history fills the gaps in submission order.
+    yurei_event_t event;
+    assert(event_queue_pop(queue, &event, false) && !event.backfill && event.data.pumpfun_trade.slot == 500);
+    assert(event_queue_pop(queue, &event, false) && !event.backfill);
+    assert(event_queue_pop(queue, &event, false) && event.backfill && event.data.pumpfun_trade.slot == 10);
+    assert(event_queue_push(queue, &live));
+    assert(event_queue_pop(queue, &event, false) && !event.backfill);
+    assert(event_queue_pop(queue, &event, false) && event.data.pumpfun_trade.slot == 11);
+    assert(event_queue_pop(queue, &event, false) && event.data.pumpfun_trade.slot == 12);
+    assert(!event_queue_pop(queue, &event, false));
+
+    // A closed queue still hands out what was queued, then refuses pushes.
+    assert(event_queue_push_backfill(queue, history, 1));
+    event_queue_close(queue);
+    assert(!event_queue_push_backfill(queue, history, 1));
+    assert(event_queue_pop(queue, &event, true) && event.backfill);
+    assert(!event_queue_pop(queue, &event, true));
+    event_queue_destroy(queue);
+    return 0;
+}
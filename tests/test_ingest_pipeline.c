@@ -0,0 +1,98 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#define _DEFAULT_SOURCE  // usleep
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "event_queue.h"
+#include "ingest_pipeline.h"
+
+#define MESSAGES 600
+#define WORKERS 4
+#define DEPTH 8
+
+typedef struct {
+    uint64_t seq;
+} message_t;
+
+static _Atomic unsigned next_worker;
+static _Atomic unsigned decoded;
+static _Thread_local unsigned worker_id;
+
+// Message `seq` decodes to seq % 3 events, all carrying seq as their slot.
+static size_t events_of(uint64_t seq) {
+    return seq % 3;
+}
+
+// Each worker decodes at its own pace and some messages take much longer,
+// so later messages regularly finish before earlier ones.
+static void decode(void *ctx, void *message, uint64_t recv_ns, yurei_event_batch_t *out) {
+    (void)ctx;
+    (void)recv_ns;
+    if (worker_id == 0)
+        worker_id = atomic_fetch_add(&next_worker, 1) + 1;
+    message_t *msg = message;
+    unsigned delay_us = worker_id * 150;
+    if (msg->seq % 7 == 0)
+        delay_us += 1000;
+    usleep(delay_us);
+    for (size_t i = 0; i < events_of(msg->seq); ++i) {
+        yurei_event_t event;
+        memset(&event, 0, sizeof(event));
+        event.type = YUREI_EVENT_PUMPFUN_TRADE;
+        event.data.pumpfun_trade.slot = msg->seq;
+        assert(event_batch_append(out, &event));
+    }
+    free(msg);
+    atomic_fetch_add(&decoded, 1);
+}
+
+int main(void) {
+    size_t expected = 0;
+    for (uint64_t seq = 0; seq < MESSAGES; ++seq)
+        expected += events_of(seq);
+    yurei_event_queue_t *queue = event_queue_create(expected);
+    assert(queue);
+    yurei_ingest_pipeline_t *pipeline = ingest_pipeline_create(WORKERS, DEPTH, queue, decode, NULL);
+    assert(pipeline);
+
+    for (uint64_t seq = 0; seq < MESSAGES; ++seq) {
+        message_t *msg = malloc(sizeof(*msg));
+        assert(msg);
+        msg->seq = seq;
+        assert(ingest_pipeline_submit(pipeline, msg, NULL, 0));
+    }
+    // Up to DEPTH messages are still in flight: destroy must drain them.
+    ingest_pipeline_destroy(pipeline);
+    assert(atomic_load(&decoded) == MESSAGES);
+    assert(atomic_load(&next_worker) > 1);
+
+    // Events come out in submission order, every one of them.
+    yurei_event_t event;
+    uint64_t last = 0;
+    size_t run = 0;
+    size_t popped = 0;
+    while (event_queue_pop(queue, &event, false)) {
+        uint64_t seq = event.data.pumpfun_trade.slot;
+        assert(seq >= last);
+        if (seq != last) {
+            assert(popped == 0 || run == events_of(last));
+            last = seq;
+            run = 0;
+        }
+        run++;
+        popped++;
+    }
+    assert(run == events_of(last));
+    assert(popped == expected);
+    event_queue_destroy(queue);
+    return 0;
+}
@@ -0,0 +1,44 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "pb_arena.h"
+
+int main(void) {
+    yurei_pb_arena_t arena;
+    assert(pb_arena_init(&arena, 256));
+
+    // Allocations are aligned and go through the protobuf-c allocator hooks.
+    uint8_t *a = arena.allocator.alloc(arena.allocator.allocator_data, 3);
+    uint8_t *b = arena.allocator.alloc(arena.allocator.allocator_data, 40);
+    assert(a && b);
+    assert(((uintptr_t)b % sizeof(void *)) == 0);
+    memset(b, 0xAB, 40);
+    arena.allocator.free(arena.allocator.allocator_data, a);
+
+    // Oversized requests grow the chain instead of failing.
+    uint8_t *big = pb_arena_alloc(&arena, 4096);
+    assert(big);
+    memset(big, 0xCD, 4096);
+    size_t reserved = arena.reserved;
+    assert(reserved >= 256 + 4096);
+
+    // Reset rewinds to the first chunk and keeps the grown chunks for reuse.
+    pb_arena_reset(&arena);
+    assert(arena.used == 0);
+    assert(arena.high_water >= 4096);
+    uint8_t *again = pb_arena_alloc(&arena, 3);
+    assert(again == a);
+    assert(pb_arena_alloc(&arena, 4096) != NULL);
+    assert(arena.reserved == reserved);
+
+    assert(pb_arena_thread_local() != NULL);
+    assert(pb_arena_thread_local() == pb_arena_thread_local());
+
+    pb_arena_destroy(&arena);
+    return 0;
+}
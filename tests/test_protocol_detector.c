@@ -7,18 +7,25 @@
 
 #include "protocol_detector.h"
 
+#define PROGRAMS 50
+
+static void make_key(uint8_t key[32], unsigned seed) {
+    for (int i = 0; i < 32; ++i)
+        key[i] = (uint8_t)(seed * 131 + i * 7 + 5);
+}
+
 int main(void) {
     uint8_t pumpfun_program[32];
     for (int i = 0; i < 32; ++i)
         pumpfun_program[i] = (uint8_t)(i + 5);
 
     yurei_protocol_detector_t detector;
-    protocol_detector_init(&detector, pumpfun_program, true, NULL, false);
+    protocol_detector_init(&detector);
+    assert(protocol_detector_add(&detector, pumpfun_program, YUREI_PROTOCOL_PUMPFUN));
 
-    const uint8_t *accounts[1];
-    size_t lens[1];
+    const uint8_t *accounts[2];
+    size_t lens[2] = {32, 32};
     accounts[0] = pumpfun_program;
-    lens[0] = 32;
 
     yurei_protocol_t proto = protocol_detector_match_accounts(&detector, accounts, lens, 1);
     assert(proto == YUREI_PROTOCOL_PUMPFUN);
@@ -27,5 +34,79 @@ int main(void) {
     accounts[0] = random_account;
     proto = protocol_detector_match_accounts(&detector, accounts, lens, 1);
     assert(proto == YUREI_PROTOCOL_NONE);
+
+    // The first watched key in account order decides.
+    accounts[1] = pumpfun_program;
+    assert(protocol_detector_match_accounts(&detector, accounts, lens, 2) == YUREI_PROTOCOL_PUMPFUN);
+
+    // A key sharing the 8-byte prefix still needs the full compare.
+    uint8_t twin[32];
+    memcpy(twin, pumpfun_program, 32);
+    twin[31] ^= 0xFF;
+    assert(protocol_detector_lookup(&detector, twin) == YUREI_PROTOCOL_NONE);
+    assert(protocol_detector_add(&detector, twin, YUREI_PROTOCOL_RAYDIUM));
+    assert(protocol_detector_lookup(&detector, twin) == YUREI_PROTOCOL_RAYDIUM);
+    assert(protocol_detector_lookup(&detector, pumpfun_program) == YUREI_PROTOCOL_PUMPFUN);
+
+    // Fill up to 50 programs; every one is found, removal keeps the rest.
+    uint8_t keys[PROGRAMS][32];
+    for (unsigned i = 0; i < PROGRAMS; ++i) {
+        make_key(keys[i], i + 1);
+        assert(protocol_detector_add(&detector, keys[i], i % 2 ? YUREI_PROTOCOL_RAYDIUM : YUREI_PROTOCOL_PUMPFUN));
+    }
+    assert(detector.n_programs == PROGRAMS + 2);
+    for (unsigned i = 0; i < PROGRAMS; ++i)
+        assert(protocol_detector_lookup(&detector, keys[i]) ==
+               (i % 2 ? YUREI_PROTOCOL_RAYDIUM : YUREI_PROTOCOL_PUMPFUN));
+    assert(protocol_detector_remove(&detector, keys[10]));
+    assert(!protocol_detector_remove(&detector, keys[10]));
+    assert(protocol_detector_lookup(&detector, keys[10]) == YUREI_PROTOCOL_NONE);
+    assert(protocol_detector_lookup(&detector, keys[11]) == YUREI_PROTOCOL_RAYDIUM);
+
+    // Re-adding moves the program to another protocol instead of duplicating it.
+    assert(protocol_detector_add(&detector, keys[12], YUREI_PROTOCOL_RAYDIUM));
+    assert(detector.n_programs == PROGRAMS + 1);
+    const uint8_t *ids[YUREI_DETECTOR_MAX_PROGRAMS];
+    size_t n_raydium = protocol_detector_programs(&detector, YUREI_PROTOCOL_RAYDIUM, ids, YUREI_DETECTOR_MAX_PROGRAMS);
+    assert(n_raydium == PROGRAMS / 2 + 2);
+    assert(ids[0] == detector.programs[1].program_id);
+
+    assert(protocol_detector_remove_protocol(&detector, YUREI_PROTOCOL_PUMPFUN) == PROGRAMS + 1 - n_raydium);
+    assert(!protocol_detector_has(&detector, YUREI_PROTOCOL_PUMPFUN));
+    assert(protocol_detector_has(&detector, YUREI_PROTOCOL_RAYDIUM));
+    assert(protocol_detector_lookup(&detector, pumpfun_program) == YUREI_PROTOCOL_NONE);
+    assert(protocol_detector_lookup(&detector, keys[12]) == YUREI_PROTOCOL_RAYDIUM);
+
+    // The registry refuses programs past its capacity.
+    protocol_detector_init(&detector);
+    for (unsigned i = 0; i < YUREI_DETECTOR_MAX_PROGRAMS; ++i) {
+        uint8_t key[32];
+        make_key(key, 1000 + i);
+        assert(protocol_detector_add(&detector, key, YUREI_PROTOCOL_PUMPFUN));
+    }
+    assert(!protocol_detector_add(&detector, pumpfun_program, YUREI_PROTOCOL_PUMPFUN));
+    assert(!protocol_detector_add(&detector, pumpfun_program, YUREI_PROTOCOL_NONE));
+
+    // Program ids are found in raw payloads at any offset, including the
+    // last one and offsets the vector loop leaves to the tail.
+    yurei_protocol_program_t program = {.protocol = YUREI_PROTOCOL_PUMPFUN};
+    memcpy(program.program_id, pumpfun_program, 32);
+    uint8_t payload[200];
+    for (size_t offset = 0; offset + 32 <= sizeof(payload); ++offset) {
+        memset(payload, 0xAA, sizeof(payload));
+        memcpy(payload + offset, pumpfun_program, 32);
+        assert(protocol_detector_match_program(&program, payload, sizeof(payload)));
+        assert(protocol_detector_match_program(&program, payload, offset + 32));
+        assert(!protocol_detector_match_program(&program, payload, offset + 31));
+    }
+    // First and last byte matching alone is not a hit.
+    memset(payload, 0xAA, sizeof(payload));
+    payload[40] = pumpfun_program[0];
+    payload[71] = pumpfun_program[31];
+    assert(!protocol_detector_match_program(&program, payload, sizeof(payload)));
+
+    yurei_protocol_t parsed;
+    assert(protocol_detector_parse_name("raydium", &parsed) && parsed == YUREI_PROTOCOL_RAYDIUM);
+    assert(!protocol_detector_parse_name("none", &parsed));
     return 0;
 }
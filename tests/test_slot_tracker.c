@@ -0,0 +1,71 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "metrics.h"
+#include "slot_tracker.h"
+
+int main(void) {
+    metrics_init();
+    yurei_slot_tracker_t *tracker = slot_tracker_create(256, 10, 4);
+    assert(tracker);
+    yurei_slot_gap_t gap;
+
+    // Contiguous slots, and a skip the parent link accounts for
+    for (uint64_t slot = 1000; slot < 1020; ++slot)
+        slot_tracker_observe(tracker, slot, slot - 1);
+    slot_tracker_observe(tracker, 1023, 1019);
+    for (uint64_t slot = 1024; slot < 1040; ++slot)
+        slot_tracker_observe(tracker, slot, slot - 1);
+    assert(!slot_tracker_next_gap(tracker, &gap));
+
+    // 1040..1044 never arrive; 1045 has no parent to vouch for them
+    for (uint64_t slot = 1045; slot < 1050; ++slot)
+        slot_tracker_observe(tracker, slot, 0);
+    // Still inside the grace window
+    assert(!slot_tracker_next_gap(tracker, &gap));
+    // A late arrival inside the window fills its slot
+    slot_tracker_observe(tracker, 1042, 0);
+    for (uint64_t slot = 1050; slot < 1070; ++slot)
+        slot_tracker_observe(tracker, slot, slot - 1);
+    assert(slot_tracker_next_gap(tracker, &gap));
+    assert(gap.start == 1040 && gap.end == 1042);
+    assert(slot_tracker_next_gap(tracker, &gap));
+    assert(gap.start == 1043 && gap.end == 1045);
+    assert(!slot_tracker_next_gap(tracker, &gap));
+    assert(atomic_load(&g_metrics.slot_gaps) == 2);
+    assert(atomic_load(&g_metrics.slot_gap_slots) == 4);
+
+    // Slots already judged are ignored
+    slot_tracker_observe(tracker, 1041, 0);
+    assert(!slot_tracker_next_gap(tracker, &gap));
+
+    // A jump past the ring is one gap, handed out once a slot closes it
+    slot_tracker_observe(tracker, 5000, 0);
+    assert(!slot_tracker_next_gap(tracker, &gap));
+    for (uint64_t slot = 5001; slot < 5020; ++slot)
+        slot_tracker_observe(tracker, slot, slot - 1);
+    assert(slot_tracker_next_gap(tracker, &gap));
+    assert(gap.start == 1070 && gap.end == 5000);
+    assert(!slot_tracker_next_gap(tracker, &gap));
+
+    // With the repair queue full further gaps are unrecoverable
+    uint64_t slot = 6000;
+    for (int i = 0; i < 6; ++i) {
+        slot_tracker_observe(tracker, slot, 0);
+        slot += 2;
+    }
+    for (uint64_t end = slot + 20; slot < end; ++slot)
+        slot_tracker_observe(tracker, slot, slot - 1);
+    assert(atomic_load(&g_metrics.slot_gaps_unrecoverable) > 0);
+    int queued = 0;
+    while (slot_tracker_next_gap(tracker, &gap))
+        queued++;
+    assert(queued == 4);
+
+    slot_tracker_destroy(tracker);
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#define _DEFAULT_SOURCE  // mkdtemp
+
+#include <assert.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "stream_recorder.h"
+
+#define RECORDS 200
+
+static void fill(uint8_t *buf, size_t len, unsigned seed) {
+    for (size_t i = 0; i < len; ++i)
+        buf[i] = (uint8_t)(seed * 31 + i);
+}
+
+static int compare_names(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+int main(void) {
+    char dir[] = "/tmp/yurei-capture-test-XXXXXX";
+    assert(mkdtemp(dir));
+
+    // Small segments force rotation; the ring is large enough for everything.
+    yurei_stream_recorder_t *recorder = stream_recorder_create(dir, 4096, 1 << 20);
+    assert(recorder);
+    uint8_t payload[700];
+    for (unsigned i = 0; i < RECORDS; ++i) {
+        size_t len = (i * 37) % sizeof(payload);
+        fill(payload, len, i);
+        assert(stream_recorder_write(recorder, 1700000000000000000ll + i, payload, len));
+    }
+    stream_recorder_destroy(recorder);
+
+    char *names[256];
+    size_t n_names = 0;
+    DIR *d = opendir(dir);
+    assert(d);
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL) {
+        if (entry->d_name[0] == '.')
+            continue;
+        assert(n_names < 256);
+        names[n_names++] = strdup(entry->d_name);
+    }
+    closedir(d);
+    assert(n_names > 1);
+    qsort(names, n_names, sizeof(names[0]), compare_names);
+
+    // Reading the segments in name order gives back every record in order.
+    unsigned next = 0;
+    for (size_t f = 0; f < n_names; ++f) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", dir, names[f]);
+        yurei_capture_reader_t reader;
+        assert(capture_reader_open(&reader, path));
+        int64_t ts;
+        const uint8_t *data;
+        size_t len;
+        while (capture_reader_next(&reader, &ts, &data, &len)) {
+            size_t expected_len = (next * 37) % sizeof(payload);
+            assert(ts == 1700000000000000000ll + next);
+            assert(len == expected_len);
+            fill(payload, len, next);
+            assert(len == 0 || memcmp(data, payload, len) == 0);
+            next++;
+        }
+        capture_reader_close(&reader);
+        unlink(path);
+        free(names[f]);
+    }
+    assert(next == RECORDS);
+
+    // A record that cannot fit in the ring is dropped, not waited for.
+    recorder = stream_recorder_create(dir, 4096, 4096);
+    assert(recorder);
+    uint8_t big[5000] = {0};
+    assert(!stream_recorder_write(recorder, 1, big, sizeof(big)));
+    assert(stream_recorder_write(recorder, 2, big, 100));
+    stream_recorder_destroy(recorder);
+
+    d = opendir(dir);
+    assert(d);
+    while ((entry = readdir(d)) != NULL) {
+        if (entry->d_name[0] == '.')
+            continue;
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+        unlink(path);
+    }
+    closedir(d);
+    rmdir(dir);
+    return 0;
+}
@@ -0,0 +1,33 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#include <assert.h>
+
+#include "topology.h"
+
+int main(void) {
+    yurei_cpu_list_t cpus;
+    assert(topology_parse_cpus("", &cpus) && cpus.count == 0);
+    assert(topology_parse_cpus("3", &cpus) && cpus.count == 1 && cpus.cpus[0] == 3);
+    assert(topology_parse_cpus("0,2-4,7", &cpus) && cpus.count == 5);
+    assert(cpus.cpus[0] == 0 && cpus.cpus[1] == 2 && cpus.cpus[3] == 4 && cpus.cpus[4] == 7);
+    assert(!topology_parse_cpus("4-2", &cpus));
+    assert(!topology_parse_cpus("1,,2", &cpus));
+    assert(!topology_parse_cpus("a", &cpus));
+    assert(!topology_parse_cpus("0-100000", &cpus));
+
+    // Pinning to a CPU the process may already use, then restoring
+    yurei_cpu_list_t current;
+    assert(topology_current_cpus(&current) && current.count > 0);
+    assert(topology_pin_thread(pthread_self(), &current, 0));
+    yurei_cpu_list_t pinned;
+    assert(topology_current_cpus(&pinned) && pinned.count == 1 && pinned.cpus[0] == current.cpus[0]);
+    assert(topology_bind_thread(pthread_self(), &current));
+    assert(topology_current_cpus(&pinned) && pinned.count == current.count);
+
+    // Empty lists leave the thread alone
+    yurei_cpu_list_t none = {.count = 0};
+    assert(topology_pin_thread(pthread_self(), &none, 5));
+    return 0;
+}
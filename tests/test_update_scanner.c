@@ -0,0 +1,202 @@
+// Project Yurei - High-performance Solana data engine
+// Copyright 2025 Project Yurei. All rights reserved.
+// https://x.com/yureiai
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "update_scanner.h"
+
+typedef struct {
+    uint8_t data[4096];
+    size_t len;
+} pb_buf_t;
+
+static void put_varint(pb_buf_t *b, uint64_t v) {
+    while (v >= 0x80) {
+        b->data[b->len++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    b->data[b->len++] = (uint8_t)v;
+}
+
+static void put_uint(pb_buf_t *b, uint32_t field, uint64_t v) {
+    put_varint(b, (uint64_t)field << 3);
+    put_varint(b, v);
+}
+
+static void put_bytes(pb_buf_t *b, uint32_t field, const void *data, size_t len) {
+    put_varint(b, ((uint64_t)field << 3) | 2);
+    put_varint(b, len);
+    memcpy(b->data + b->len, data, len);
+    b->len += len;
+}
+
+static void put_message(pb_buf_t *b, uint32_t field, const pb_buf_t *inner) {
+    put_bytes(b, field, inner->data, inner->len);
+}
+
+int main(void) {
+    uint8_t keys[3][32];
+    for (int k = 0; k < 3; ++k)
+        for (int i = 0; i < 32; ++i)
+            keys[k][i] = (uint8_t)(k * 32 + i);
+    uint8_t signature[64];
+    for (int i = 0; i < 64; ++i)
+        signature[i] = (uint8_t)(0xF0 ^ i);
+    const char *log0 = "Program 6EF8rrecthR5Dkzon8Nwu78hRvfCKubJ14M5uBEwF6P invoke [1]";
+    const char *log1 = "Program data: AAAA";
+
+    pb_buf_t message = {0};
+    put_bytes(&message, 1, "\x08\x01", 2);  // header, skipped
+    for (int k = 0; k < 3; ++k)
+        put_bytes(&message, 2, keys[k], 32);
+    put_bytes(&message, 3, signature, 32);  // recent_blockhash
+
+    pb_buf_t transaction = {0};
+    put_bytes(&transaction, 1, signature, 64);
+    put_message(&transaction, 2, &message);
+
+    pb_buf_t meta = {0};
+    put_uint(&meta, 2, 5000);  // fee
+    uint8_t packed_balances[] = {0x01, 0x02, 0x03};
+    put_bytes(&meta, 3, packed_balances, sizeof(packed_balances));
+    put_bytes(&meta, 6, log0, strlen(log0));
+    put_bytes(&meta, 6, log1, strlen(log1));
+    put_uint(&meta, 16, 1234);  // compute_units_consumed
+
+    pb_buf_t info = {0};
+    put_bytes(&info, 1, signature, 64);
+    put_uint(&info, 2, 0);
+    put_message(&info, 3, &transaction);
+    put_message(&info, 4, &meta);
+    put_uint(&info, 5, 17);
+
+    pb_buf_t tx_update = {0};
+    put_message(&tx_update, 1, &info);
+    put_uint(&tx_update, 2, 301234567);
+
+    pb_buf_t created_at = {0};
+    put_uint(&created_at, 1, 1700000000);
+    put_uint(&created_at, 2, 250000000);
+
+    pb_buf_t update = {0};
+    put_bytes(&update, 1, "pumpfun", 7);
+    put_bytes(&update, 1, "raydium", 7);
+    put_message(&update, 4, &tx_update);
+    put_message(&update, 11, &created_at);
+
+    yurei_tx_view_t view;
+    assert(update_scanner_scan(update.data, update.len, &view));
+    assert(view.kind == YUREI_UPDATE_TRANSACTION);
+    assert(view.has_slot && view.slot == 301234567);
+    assert(view.signature_len == 64 && memcmp(view.signature, signature, 64) == 0);
+    assert(view.n_account_keys == 3);
+    for (int k = 0; k < 3; ++k) {
+        assert(view.account_key_lens[k] == 32);
+        assert(memcmp(view.account_keys[k], keys[k], 32) == 0);
+        // Borrowed pointers point into the scanned buffer.
+        assert(view.account_keys[k] > update.data && view.account_keys[k] < update.data + update.len);
+    }
+    assert(view.n_log_messages == 2);
+    assert(view.log_message_lens[1] == strlen(log1));
+    assert(memcmp(view.log_messages[1], log1, strlen(log1)) == 0);
+    assert(!view.truncated);
+    assert(view.encoded_len == update.len);
+    assert(view.has_tx_index && view.tx_index == 17);
+    assert(view.has_created_at && view.created_at_ns == 1700000000250000000ll);
+    assert(view.n_filters == 2);
+    assert(view.filter_lens[0] == 7 && memcmp(view.filters[0], "pumpfun", 7) == 0);
+    assert(view.filter_lens[1] == 7 && memcmp(view.filters[1], "raydium", 7) == 0);
+
+    // Truncated input is rejected rather than over-read.
+    assert(!update_scanner_scan(update.data, update.len - 3, &view));
+
+    // Non-transaction updates only report their kind.
+    pb_buf_t ping = {0};
+    put_bytes(&ping, 6, "", 0);
+    assert(update_scanner_scan(ping.data, ping.len, &view));
+    assert(view.kind == YUREI_UPDATE_PING);
+    assert(view.n_account_keys == 0);
+    assert(view.n_filters == 0);
+
+    // Pongs carry back the id of the ping they answer.
+    pb_buf_t pong_body = {0};
+    put_uint(&pong_body, 1, 42);
+    pb_buf_t pong = {0};
+    put_message(&pong, 9, &pong_body);
+    assert(update_scanner_scan(pong.data, pong.len, &view));
+    assert(view.kind == YUREI_UPDATE_PONG);
+    assert(view.pong_id == 42);
+
+    // Slot status updates report slot, parent and status.
+    pb_buf_t slot_body = {0};
+    put_uint(&slot_body, 1, 250000123);
+    put_uint(&slot_body, 2, 250000121);
+    put_uint(&slot_body, 3, 6);
+    put_bytes(&slot_body, 4, "dead", 4);
+    pb_buf_t slot_update = {0};
+    put_message(&slot_update, 3, &slot_body);
+    assert(update_scanner_scan(slot_update.data, slot_update.len, &view));
+    assert(view.kind == YUREI_UPDATE_SLOT);
+    assert(view.has_slot && view.slot == 250000123);
+    assert(view.has_parent_slot && view.parent_slot == 250000121);
+    assert(view.slot_status == 6);
+
+    // Account updates carry pubkey, owner, the sliced data and write version.
+    uint8_t sliced[41];
+    memset(sliced, 0x5A, sizeof(sliced));
+    pb_buf_t account_info = {0};
+    put_bytes(&account_info, 1, keys[0], 32);
+    put_uint(&account_info, 2, 1461600);
+    put_bytes(&account_info, 3, keys[1], 32);
+    put_bytes(&account_info, 6, sliced, sizeof(sliced));
+    put_uint(&account_info, 7, 987654321);
+    pb_buf_t account_body = {0};
+    put_message(&account_body, 1, &account_info);
+    put_uint(&account_body, 2, 250000200);
+    pb_buf_t account_update = {0};
+    put_bytes(&account_update, 1, "pumpfun_curves", 14);
+    put_message(&account_update, 2, &account_body);
+    assert(update_scanner_scan(account_update.data, account_update.len, &view));
+    assert(view.kind == YUREI_UPDATE_ACCOUNT);
+    assert(view.has_slot && view.slot == 250000200);
+    assert(view.account_pubkey_len == 32 && memcmp(view.account_pubkey, keys[0], 32) == 0);
+    assert(view.account_owner_len == 32 && memcmp(view.account_owner, keys[1], 32) == 0);
+    assert(view.account_data_len == sizeof(sliced) && view.account_data[40] == 0x5A);
+    assert(view.write_version == 987654321);
+    assert(view.n_filters == 1 && view.filter_lens[0] == 14);
+
+    // Block updates are iterated transaction by transaction.
+    pb_buf_t block_time = {0};
+    put_uint(&block_time, 1, 1700000123);
+    pb_buf_t block_body = {0};
+    put_uint(&block_body, 1, 250000300);
+    put_bytes(&block_body, 2, "hash", 4);
+    put_message(&block_body, 4, &block_time);
+    put_message(&block_body, 6, &info);
+    put_uint(&block_body, 7, 250000299);
+    put_message(&block_body, 6, &info);
+    pb_buf_t block = {0};
+    put_bytes(&block, 1, "blocks", 6);
+    put_message(&block, 5, &block_body);
+    yurei_tx_view_t block_view;
+    assert(update_scanner_scan(block.data, block.len, &block_view));
+    assert(block_view.kind == YUREI_UPDATE_BLOCK);
+    assert(block_view.has_slot && block_view.slot == 250000300);
+    assert(block_view.has_parent_slot && block_view.parent_slot == 250000299);
+    assert(block_view.has_block_time && block_view.block_time == 1700000123);
+    yurei_block_cursor_t cursor;
+    update_scanner_block_begin(&block_view, &cursor);
+    size_t n_block_txs = 0;
+    while (update_scanner_block_next(&cursor, &block_view, &view)) {
+        assert(view.kind == YUREI_UPDATE_TRANSACTION);
+        assert(view.slot == 250000300 && view.block_time == 1700000123);
+        assert(view.has_tx_index && view.tx_index == 17);
+        assert(view.signature_len == 64 && view.n_account_keys == 3 && view.n_log_messages == 2);
+        n_block_txs++;
+    }
+    assert(n_block_txs == 2 && !cursor.malformed);
+    return 0;
+}